@@ -22,11 +22,65 @@ uint64_t averageDmg(const DamageRange & range)
 	return (range.min + range.max) / 2;
 }
 
+uint32_t DamageCache::getUnitSlot(uint32_t unitId)
+{
+	auto slot = unitSlots.find(unitId);
+
+	if(slot != unitSlots.end())
+		return slot->second;
+
+	uint32_t newSlot = unitSlots.size();
+
+	reserveSlots(newSlot + 1);
+	unitSlots[unitId] = newSlot;
+
+	return newSlot;
+}
+
+int32_t DamageCache::findUnitSlot(uint32_t unitId) const
+{
+	auto slot = unitSlots.find(unitId);
+
+	return slot == unitSlots.end() ? -1 : slot->second;
+}
+
+void DamageCache::reserveSlots(uint32_t count)
+{
+	if(count <= slotCapacity)
+		return;
+
+	uint32_t newCapacity = std::max<uint32_t>(count, std::max<uint32_t>(16, slotCapacity * 2));
+	std::vector<float> newMatrix(newCapacity * newCapacity, -1.0f);
+
+	for(uint32_t attackerSlot = 0; attackerSlot < slotCapacity; attackerSlot++)
+	{
+		auto row = damageMatrix.begin() + attackerSlot * slotCapacity;
+
+		std::copy(row, row + slotCapacity, newMatrix.begin() + attackerSlot * newCapacity);
+	}
+
+	damageMatrix = std::move(newMatrix);
+	slotCapacity = newCapacity;
+}
+
+float DamageCache::findDamage(const battle::Unit * attacker, const battle::Unit * defender) const
+{
+	auto attackerSlot = findUnitSlot(attacker->unitId());
+	auto defenderSlot = findUnitSlot(defender->unitId());
+
+	if(attackerSlot < 0 || defenderSlot < 0)
+		return -1.0f;
+
+	return damageMatrix[attackerSlot * slotCapacity + defenderSlot];
+}
+
 void DamageCache::cacheDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
 	auto damage = averageDmg(hb->battleEstimateDamage(attacker, defender, 0).damage);
+	auto attackerSlot = getUnitSlot(attacker->unitId());
+	auto defenderSlot = getUnitSlot(defender->unitId());
 
-	damageCache[attacker->unitId()][defender->unitId()] = static_cast<float>(damage) / attacker->getCount();
+	damageMatrix[attackerSlot * slotCapacity + defenderSlot] = static_cast<float>(damage) / attacker->getCount();
 }
 
 void DamageCache::buildObstacleDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleSide side)
@@ -72,9 +126,15 @@ void DamageCache::buildObstacleDamageCache(std::shared_ptr<HypotheticBattle> hb,
 
 			auto damageDealt = stack->getAvailableHealth() - updated->getAvailableHealth();
 
+			auto slot = getUnitSlot(stack->unitId());
+
+			if(obstacleDamage.size() < unitSlots.size() * GameConstants::BFIELD_SIZE)
+				obstacleDamage.resize(unitSlots.size() * GameConstants::BFIELD_SIZE, 0);
+
 			for(auto hex : affectedHexes)
 			{
-				obstacleDamage[hex][stack->unitId()] = damageDealt;
+				if(hex.isValid())
+					obstacleDamage[slot * GameConstants::BFIELD_SIZE + hex.hex] = damageDealt;
 			}
 		}
 	}
@@ -95,8 +155,12 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleS
 	std::vector<const battle::Unit *> ourUnits;
 	std::vector<const battle::Unit *> enemyUnits;
 
+	reserveSlots(unitSlots.size() + stacks.size());
+
 	for(auto stack : stacks)
 	{
+		getUnitSlot(stack->unitId());
+
 		if(stack->unitSide() == side)
 			ourUnits.push_back(stack);
 		else
@@ -121,12 +185,14 @@ void DamageCache::buildDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleS
 
 int64_t DamageCache::getDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
-	bool wasComputedBefore = damageCache[attacker->unitId()].count(defender->unitId());
+	auto attackerSlot = getUnitSlot(attacker->unitId());
+	auto defenderSlot = getUnitSlot(defender->unitId());
+	bool wasComputedBefore = damageMatrix[attackerSlot * slotCapacity + defenderSlot] >= 0;
 
 	if (!wasComputedBefore)
 		cacheDamage(attacker, defender, hb);
 
-	return damageCache[attacker->unitId()][defender->unitId()] * attacker->getCount();
+	return damageMatrix[attackerSlot * slotCapacity + defenderSlot] * attacker->getCount();
 }
 
 int64_t DamageCache::getObstacleDamage(BattleHex hex, const battle::Unit * defender)
@@ -134,32 +200,27 @@ int64_t DamageCache::getObstacleDamage(BattleHex hex, const battle::Unit * defen
 	if(parent)
 		return parent->getObstacleDamage(hex, defender);
 
-	auto damages = obstacleDamage.find(hex);
+	auto slot = findUnitSlot(defender->unitId());
 
-	if(damages == obstacleDamage.end())
+	if(slot < 0 || !hex.isValid())
 		return 0;
 
-	auto damage = damages->second.find(defender->unitId());
+	size_t index = slot * GameConstants::BFIELD_SIZE + hex.hex;
 
-	return damage == damages->second.end()
-		? 0
-		: damage->second;
+	return index < obstacleDamage.size()
+		? obstacleDamage[index]
+		: 0;
 }
 
 int64_t DamageCache::getOriginalDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb)
 {
 	if(parent)
 	{
-		auto attackerDamageMap = parent->damageCache.find(attacker->unitId());
+		auto damage = parent->findDamage(attacker, defender);
 
-		if(attackerDamageMap != parent->damageCache.end())
+		if(damage >= 0)
 		{
-			auto targetDamage = attackerDamageMap->second.find(defender->unitId());
-
-			if(targetDamage != attackerDamageMap->second.end())
-			{
-				return static_cast<int64_t>(targetDamage->second * attacker->getCount());
-			}
+			return static_cast<int64_t>(damage * attacker->getCount());
 		}
 	}
 
@@ -319,10 +380,9 @@ AttackPossibility AttackPossibility::evaluate(
 {
 	auto attacker = attackInfo.attacker;
 	auto defender = attackInfo.defender;
-	const std::string cachingStringBlocksRetaliation = "type_BLOCKS_RETALIATION";
 	static const auto selectorBlocksRetaliation = Selector::type()(BonusType::BLOCKS_RETALIATION);
 	const auto attackerSide = state->playerToSide(state->battleGetOwner(attacker));
-	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation, cachingStringBlocksRetaliation);
+	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation);
 
 	AttackPossibility bestAp(hex, BattleHex::INVALID, attackInfo);
 
@@ -17,15 +17,24 @@
 class DamageCache
 {
 private:
-	std::unordered_map<uint32_t, std::unordered_map<uint32_t, float>> damageCache;
-	std::map<BattleHex, std::unordered_map<uint32_t, int64_t>> obstacleDamage;
+	/// damage of single attacker creature, indexed by attacker slot * slotCapacity + defender slot, negative if not computed yet
+	std::vector<float> damageMatrix;
+	/// indexed by unit slot * BFIELD_SIZE + hex, empty if there are no harmful obstacles
+	std::vector<int64_t> obstacleDamage;
+	boost::container::flat_map<uint32_t, uint32_t> unitSlots;
+	uint32_t slotCapacity;
 	DamageCache * parent;
 
 	void buildObstacleDamageCache(std::shared_ptr<HypotheticBattle> hb, BattleSide side);
 
+	uint32_t getUnitSlot(uint32_t unitId);
+	int32_t findUnitSlot(uint32_t unitId) const;
+	void reserveSlots(uint32_t count);
+	float findDamage(const battle::Unit * attacker, const battle::Unit * defender) const;
+
 public:
-	DamageCache() : parent(nullptr) {}
-	DamageCache(DamageCache * parent) : parent(parent) {}
+	DamageCache() : slotCapacity(0), parent(nullptr) {}
+	DamageCache(DamageCache * parent) : slotCapacity(0), parent(parent) {}
 
 	void cacheDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb);
 	int64_t getDamage(const battle::Unit * attacker, const battle::Unit * defender, std::shared_ptr<CBattleInfoCallback> hb);
@@ -24,6 +24,8 @@
 #include "../../lib/battle/BattleStateInfoForRetreat.h"
 #include "../../lib/battle/CObstacleInstance.h"
 #include "../../lib/StartInfo.h"
+#include "../../lib/CConfigHandler.h"
+#include "../../lib/ScopeGuard.h"
 #include "../../lib/CStack.h" // TODO: remove
                               // Eventually only IBattleInfoCallback and battle::Unit should be used,
                               // CUnitState should be private and CStack should be removed completely
@@ -128,6 +130,23 @@ int getSimulationTurnsCount(const StartInfo * startInfo)
 	return startInfo->difficulty < 4 ? 2 : 10;
 }
 
+/// Time in ms for single battle decision, 0 if unlimited
+int getDecisionTimeLimit(const StartInfo * startInfo)
+{
+	int timeLimit = settings["server"]["battleAITimeLimit"].Integer();
+	const auto & timer = startInfo->turnTimerInfo;
+
+	if(timer.isBattleEnabled() && timer.unitTimer > 0)
+	{
+		// keep half of unit timer in reserve for action itself and possible server delays
+		int timerLimit = timer.unitTimer / 2;
+
+		timeLimit = timeLimit > 0 ? std::min(timeLimit, timerLimit) : timerLimit;
+	}
+
+	return timeLimit;
+}
+
 void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 {
 	LOG_TRACE_PARAMS(logAi, "stack: %s", stack->nodeName());
@@ -142,6 +161,17 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 	BattleAction result = BattleAction::makeDefend(stack);
 
 	auto start = std::chrono::high_resolution_clock::now();
+	auto timeLimit = getDecisionTimeLimit(env->game()->getStartInfo());
+	uint64_t actionSelectionTime = 0;
+
+	auto logDecisionTime = vstd::makeScopeGuard([&]()
+	{
+		logAi->debug("BattleAI: decision for %s took %d ms, action selection %d ms, time limit %d ms",
+			stack->getDescription(),
+			timeElapsed(start),
+			actionSelectionTime,
+			timeLimit);
+	});
 
 	try
 	{
@@ -165,7 +195,11 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 			getStrengthRatio(cb->getBattle(battleID), side),
 			getSimulationTurnsCount(env->game()->getStartInfo()));
 
+		if(timeLimit > 0)
+			evaluator.setDeadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeLimit));
+
 		result = evaluator.selectStackAction(stack);
+		actionSelectionTime = timeElapsed(start);
 
 		if(autobattlePreferences.enableSpellsUsage && !skipCastUntilNextBattle && evaluator.canCastSpell())
 		{
@@ -173,8 +207,10 @@ void CBattleAI::activeStack(const BattleID & battleID, const CStack * stack )
 
 			if(spelCasted)
 				return;
-			
-			skipCastUntilNextBattle = true;
+
+			// running out of time does not mean that spells are useless in this battle
+			if(!evaluator.wasSpellEvaluationInterrupted())
+				skipCastUntilNextBattle = true;
 		}
 
 		logAi->trace("Spellcast attempt completed in %lld", timeElapsed(start));
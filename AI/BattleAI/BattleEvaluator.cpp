@@ -87,6 +87,17 @@ BattleEvaluator::BattleEvaluator(
 	targets = std::make_unique<PotentialTargets>(activeStack, damageCache, hb);
 }
 
+void BattleEvaluator::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	this->deadline = deadline;
+	scoreEvaluator.setDeadline(deadline);
+}
+
+bool BattleEvaluator::wasSpellEvaluationInterrupted() const
+{
+	return spellEvaluationInterrupted;
+}
+
 std::vector<BattleHex> BattleEvaluator::getBrokenWallMoatHexes() const
 {
 	std::vector<BattleHex> result;
@@ -464,6 +475,8 @@ bool BattleEvaluator::canCastSpell()
 
 bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 {
+	spellEvaluationInterrupted = false;
+
 	auto hero = cb->getBattle(battleID)->battleGetMyHero();
 	if(!hero)
 		return false;
@@ -648,6 +661,17 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 
 	CStopWatch timer;
 
+	if(deadline)
+	{
+		// with limited time evaluate more powerful spells first
+		boost::stable_sort(possibleCasts, [](const PossibleSpellcast & lhs, const PossibleSpellcast & rhs) -> bool
+		{
+			return lhs.spell->getLevel() > rhs.spell->getLevel();
+		});
+	}
+
+	std::atomic<size_t> skippedCasts(0);
+
 #if BATTLE_TRACE_LEVEL >= 1
 	tbb::blocked_range<size_t> r(0, possibleCasts.size());
 #else
@@ -658,6 +682,14 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 			{
 				auto & ps = possibleCasts[i];
 
+				// at least the top ranked spellcast is evaluated, same as for attacks
+				if(i != 0 && scoreEvaluator.isDeadlineReached())
+				{
+					ps.value = EvaluationResult::INEFFECTIVE_SCORE;
+					skippedCasts++;
+					continue;
+				}
+
 #if BATTLE_TRACE_LEVEL >= 1
 				if(ps.dest.empty())
 					logAi->trace("Evaluating %s", ps.spell->getNameTranslated());
@@ -702,6 +734,9 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 					PotentialTargets innerTargets(activeStack, innerCache, state);
 					BattleExchangeEvaluator innerEvaluator(state, env, strengthRatio, simulationTurnsCount);
 
+					if(deadline)
+						innerEvaluator.setDeadline(*deadline);
+
 					innerEvaluator.updateReachabilityMap(state);
 
 					auto moveTarget = innerEvaluator.findMoveTowardsUnreachable(activeStack, innerTargets, innerCache, state);
@@ -790,6 +825,11 @@ bool BattleEvaluator::attemptCastingSpell(const CStack * activeStack)
 
 	LOGFL("Evaluation took %d ms", timer.getDiff());
 
+	spellEvaluationInterrupted = skippedCasts > 0;
+
+	if(spellEvaluationInterrupted)
+		logAi->debug("BattleAI: time limit reached, %d of %d spellcasts were not evaluated", skippedCasts.load(), possibleCasts.size());
+
 	auto castToPerform = *vstd::maxElementByFun(possibleCasts, [](const PossibleSpellcast & ps) -> float
 		{
 			return ps.value;
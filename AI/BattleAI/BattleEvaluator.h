@@ -45,8 +45,13 @@ class BattleEvaluator
 	DamageCache damageCache;
 	float strengthRatio;
 	int simulationTurnsCount;
+	std::optional<std::chrono::steady_clock::time_point> deadline;
+	bool spellEvaluationInterrupted = false;
 
 public:
+	void setDeadline(std::chrono::steady_clock::time_point deadline);
+	/// True if last attemptCastingSpell skipped some spellcasts because of deadline
+	bool wasSpellEvaluationInterrupted() const;
 	BattleAction selectStackAction(const CStack * stack);
 	bool attemptCastingSpell(const CStack * stack);
 	bool canCastSpell();
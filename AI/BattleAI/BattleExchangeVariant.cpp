@@ -10,6 +10,7 @@
 #include "StdInc.h"
 #include "BattleExchangeVariant.h"
 #include "../../lib/CStack.h"
+#include "../../lib/ScopeGuard.h"
 
 AttackerValue::AttackerValue()
 	: value(0),
@@ -131,9 +132,8 @@ float BattleExchangeVariant::trackAttack(
 	std::shared_ptr<HypotheticBattle> hb,
 	bool evaluateOnly)
 {
-	const std::string cachingStringBlocksRetaliation = "type_BLOCKS_RETALIATION";
 	static const auto selectorBlocksRetaliation = Selector::type()(BonusType::BLOCKS_RETALIATION);
-	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation, cachingStringBlocksRetaliation);
+	const bool counterAttacksBlocked = attacker->hasBonus(selectorBlocksRetaliation);
 
 	int64_t attackDamage = damageCache.getDamage(attacker.get(), defender.get(), hb);
 	float defenderDamageReduce = AttackPossibility::calculateDamageReduce(attacker.get(), defender.get(), attackDamage, damageCache, hb);
@@ -209,6 +209,16 @@ float BattleExchangeEvaluator::scoreValue(const BattleScore & score) const
 	return score.enemyDamageReduce * getPositiveEffectMultiplier() - score.ourDamageReduce * getNegativeEffectMultiplier();
 }
 
+void BattleExchangeEvaluator::setDeadline(std::chrono::steady_clock::time_point deadline)
+{
+	this->deadline = deadline;
+}
+
+bool BattleExchangeEvaluator::isDeadlineReached() const
+{
+	return deadline && std::chrono::steady_clock::now() >= *deadline;
+}
+
 EvaluationResult BattleExchangeEvaluator::findBestTarget(
 	const battle::Unit * activeStack,
 	PotentialTargets & targets,
@@ -217,21 +227,31 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 {
 	EvaluationResult result(targets.bestAction());
 
-	if(!activeStack->waited() && !activeStack->acquireState()->hadMorale)
+	if(!activeStack->waited() && !activeStack->acquireState()->hadMorale && !isDeadlineReached())
 	{
 #if BATTLE_TRACE_LEVEL>=1
 		logAi->trace("Evaluating waited attack for %s", activeStack->getDescription());
 #endif
 
-		auto hbWaited = std::make_shared<HypotheticBattle>(env.get(), hb);
+		auto waitSavepoint = hb->savepoint();
+		auto rollbackWait = vstd::makeScopeGuard([&hb, waitSavepoint]()
+		{
+			hb->rollback(waitSavepoint);
+		});
 
-		hbWaited->makeWait(activeStack);
+		hb->makeWait(activeStack);
 
-		updateReachabilityMap(hbWaited);
+		updateReachabilityMap(hb);
 
 		for(auto & ap : targets.possibleAttacks)
 		{
-			float score = evaluateExchange(ap, 0, targets, damageCache, hbWaited);
+			if(isDeadlineReached())
+			{
+				logAi->debug("BattleAI: time limit reached during waited attack evaluation");
+				break;
+			}
+
+			float score = evaluateExchange(ap, 0, targets, damageCache, hb);
 
 			if(score > result.score)
 			{
@@ -263,6 +283,15 @@ EvaluationResult BattleExchangeEvaluator::findBestTarget(
 
 	for(auto & ap : targets.possibleAttacks)
 	{
+		// possible attacks are sorted by cheap estimation, so at least the most promising one is evaluated
+		if(&ap != &targets.possibleAttacks.front() && isDeadlineReached())
+		{
+			logAi->debug("BattleAI: time limit reached, %d of %d attacks evaluated",
+				&ap - &targets.possibleAttacks.front(),
+				targets.possibleAttacks.size());
+			break;
+		}
+
 		float score = evaluateExchange(ap, 0, targets, damageCache, hb);
 		bool sameScoreButWaited = vstd::isAlmostEqual(score, result.score) && result.wait;
 
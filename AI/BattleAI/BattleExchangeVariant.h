@@ -133,6 +133,7 @@ private:
 	std::vector<battle::Units> turnOrder;
 	float negativeEffectMultiplier;
 	int simulationTurnsCount;
+	std::optional<std::chrono::steady_clock::time_point> deadline;
 
 	float scoreValue(const BattleScore & score) const;
 
@@ -155,6 +156,11 @@ public:
 		negativeEffectMultiplier = strengthRatio >= 1 ? 1 : strengthRatio * strengthRatio;
 	}
 
+	/// Candidate attacks are refined in order of their cheap damage estimation until deadline is reached.
+	/// Best attack found so far is returned after that
+	void setDeadline(std::chrono::steady_clock::time_point deadline);
+	bool isDeadlineReached() const;
+
 	EvaluationResult findBestTarget(
 		const battle::Unit * activeStack,
 		PotentialTargets & targets,
@@ -48,7 +48,8 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	side(Stack->unitSide()),
 	player(Stack->unitOwner()),
 	slot(Stack->unitSlot()),
-	treeVersionLocal(0)
+	treeVersionLocal(0),
+	revision(0)
 {
 	localInit(Owner);
 
@@ -65,7 +66,8 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	side(Stack->unitSide()),
 	player(Stack->unitOwner()),
 	slot(Stack->unitSlot()),
-	treeVersionLocal(0)
+	treeVersionLocal(0),
+	revision(0)
 {
 	localInit(Owner);
 
@@ -81,7 +83,8 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	id(info.id),
 	side(info.side),
 	slot(SlotID::SUMMONED_SLOT_PLACEHOLDER),
-	treeVersionLocal(0)
+	treeVersionLocal(0),
+	revision(0)
 {
 	type = info.type.toCreature();
 	origBearer = type;
@@ -94,6 +97,27 @@ StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const battle:
 	summoned = info.summoned;
 }
 
+StackWithBonuses::StackWithBonuses(const HypotheticBattle * Owner, const StackWithBonuses & other)
+	: battle::CUnitState(),
+	bonusesToAdd(other.bonusesToAdd),
+	bonusesToUpdate(other.bonusesToUpdate),
+	bonusesToRemove(other.bonusesToRemove),
+	treeVersionLocal(other.treeVersionLocal),
+	revision(other.revision),
+	origBearer(other.origBearer),
+	owner(Owner),
+	type(other.type),
+	baseAmount(other.baseAmount),
+	id(other.id),
+	side(other.side),
+	player(other.player),
+	slot(other.slot)
+{
+	localInit(Owner);
+
+	battle::CUnitState::operator=(other);
+}
+
 StackWithBonuses::~StackWithBonuses() = default;
 
 StackWithBonuses & StackWithBonuses::operator=(const battle::CUnitState & other)
@@ -252,21 +276,18 @@ void StackWithBonuses::spendMana(ServerCallback * server, const int spellCost) c
 HypotheticBattle::HypotheticBattle(const Environment * ENV, Subject realBattle)
 	: BattleProxy(realBattle),
 	env(ENV),
-	bonusTreeVersion(1)
+	bonusTreeVersion(1),
+	currentRevision(0),
+	lastRevision(0)
 {
 	auto activeUnit = realBattle->battleActiveUnit();
 	activeUnitId = activeUnit ? activeUnit->unitId() : -1;
 
 	nextId = 0x00F00000;
 
-	eventBus.reset(new events::EventBus());
-
+	//event bus and scripting pool are rarely needed by evaluation, they are created on demand
 	localEnvironment.reset(new HypotheticEnvironment(this, env));
 	serverCallback.reset(new HypotheticServerCallback(this));
-
-#if SCRIPTING_ENABLED
-	pool.reset(new scripting::PoolImpl(localEnvironment.get(), serverCallback.get()));
-#endif
 }
 
 bool HypotheticBattle::unitHasAmmoCart(const battle::Unit * unit) const
@@ -289,15 +310,68 @@ std::shared_ptr<StackWithBonuses> HypotheticBattle::getForUpdate(uint32_t id)
 		const battle::Unit * s = subject->battleGetUnitByID(id);
 
 		auto ret = std::make_shared<StackWithBonuses>(this, s);
+		ret->revision = currentRevision;
+		recordUndo(id, nullptr);
 		stackStates[id] = ret;
 		return ret;
 	}
+	else if(!savepoints.empty() && iter->second->revision != currentRevision)
+	{
+		//state is shared with savepoint, copy it on first write
+		auto ret = std::make_shared<StackWithBonuses>(this, *iter->second);
+		ret->revision = currentRevision;
+		recordUndo(id, iter->second);
+		iter->second = ret;
+		return ret;
+	}
 	else
 	{
 		return iter->second;
 	}
 }
 
+void HypotheticBattle::recordUndo(uint32_t id, std::shared_ptr<StackWithBonuses> previousState)
+{
+	if(!savepoints.empty())
+		undoLog.push_back(UnitUndoRecord{id, previousState});
+}
+
+size_t HypotheticBattle::savepoint()
+{
+	savepoints.push_back(Savepoint{undoLog.size(), activeUnitId, nextId, currentRevision});
+	currentRevision = ++lastRevision;
+
+	return savepoints.size() - 1;
+}
+
+void HypotheticBattle::rollback(size_t savepointId)
+{
+	assert(savepointId < savepoints.size());
+
+	const Savepoint restored = savepoints.at(savepointId);
+
+	while(undoLog.size() > restored.undoLogSize)
+	{
+		auto & record = undoLog.back();
+
+		if(record.previousState)
+			stackStates[record.unitId] = record.previousState;
+		else
+			stackStates.erase(record.unitId);
+
+		undoLog.pop_back();
+	}
+
+	savepoints.resize(savepointId);
+
+	activeUnitId = restored.activeUnitId;
+	nextId = restored.nextId;
+	currentRevision = restored.revision;
+
+	//never reuse tree version, bonus caches may hold values of reverted states
+	bonusTreeVersion++;
+}
+
 battle::Units HypotheticBattle::getUnitsIf(const battle::UnitFilter & predicate) const
 {
 	battle::Units proxyed = BattleProxy::getUnitsIf(predicate);
@@ -357,6 +431,11 @@ void HypotheticBattle::addUnit(uint32_t id, const JsonNode & data)
 	battle::UnitInfo info;
 	info.load(id, data);
 	auto newUnit = std::make_shared<StackWithBonuses>(this, info);
+	newUnit->revision = currentRevision;
+
+	auto iter = stackStates.find(newUnit->unitId());
+	recordUndo(newUnit->unitId(), iter == stackStates.end() ? nullptr : iter->second);
+
 	stackStates[newUnit->unitId()] = newUnit;
 }
 
@@ -493,10 +572,21 @@ int64_t HypotheticBattle::getTreeVersion() const
 #if SCRIPTING_ENABLED
 Pool * HypotheticBattle::getContextPool() const
 {
+	if(!pool)
+		pool.reset(new scripting::PoolImpl(localEnvironment.get(), serverCallback.get()));
+
 	return pool.get();
 }
 #endif
 
+events::EventBus * HypotheticBattle::getEventBus() const
+{
+	if(!eventBus)
+		eventBus.reset(new events::EventBus());
+
+	return eventBus.get();
+}
+
 ServerCallback * HypotheticBattle::getServerCallback()
 {
 	return serverCallback.get();
@@ -601,6 +691,6 @@ vstd::CLoggerBase * HypotheticBattle::HypotheticEnvironment::logger() const
 
 events::EventBus * HypotheticBattle::HypotheticEnvironment::eventBus() const
 {
-	return owner->eventBus.get();
+	return owner->getEventBus();
 }
 
@@ -14,6 +14,8 @@
 #include <vcmi/Environment.h>
 #include <vcmi/ServerCallback.h>
 
+#include <boost/container/flat_map.hpp>
+
 #include "../../lib/bonuses/Bonus.h"
 #include "../../lib/battle/BattleProxy.h"
 #include "../../lib/battle/CUnitState.h"
@@ -68,6 +70,8 @@ public:
 	std::vector<Bonus> bonusesToUpdate;
 	std::set<std::shared_ptr<Bonus>> bonusesToRemove;
 	int treeVersionLocal;
+	///savepoint revision of owner this state belongs to, see HypotheticBattle::savepoint
+	uint32_t revision;
 
 	StackWithBonuses(const HypotheticBattle * Owner, const battle::CUnitState * Stack);
 
@@ -75,6 +79,9 @@ public:
 
 	StackWithBonuses(const HypotheticBattle * Owner, const battle::UnitInfo & info);
 
+	///copy of other hypothetic state sharing same original bearer, used for copy-on-write
+	StackWithBonuses(const HypotheticBattle * Owner, const StackWithBonuses & other);
+
 	virtual ~StackWithBonuses();
 
 	StackWithBonuses & operator= (const battle::CUnitState & other);
@@ -119,7 +126,7 @@ private:
 class HypotheticBattle : public BattleProxy, public battle::IUnitEnvironment
 {
 public:
-	std::map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
+	boost::container::flat_map<uint32_t, std::shared_ptr<StackWithBonuses>> stackStates;
 
 	const Environment * env;
 
@@ -171,6 +178,12 @@ public:
 		activeUnitId = -1;
 	}
 
+	/// Remembers current state. Units changed after this call are copied on first write
+	/// and can be reverted by rollback() in O(changed units) without creating child battle
+	/// States obtained by getForUpdate before savepoint must not be modified directly
+	size_t savepoint();
+	void rollback(size_t savepointId);
+
 #if SCRIPTING_ENABLED
 	scripting::Pool * getContextPool() const override;
 #endif
@@ -219,10 +232,31 @@ private:
 		const Environment * env;
 	};
 
+	struct UnitUndoRecord
+	{
+		uint32_t unitId;
+		std::shared_ptr<StackWithBonuses> previousState;
+	};
+
+	struct Savepoint
+	{
+		size_t undoLogSize;
+		int32_t activeUnitId;
+		uint32_t nextId;
+		uint32_t revision;
+	};
+
+	void recordUndo(uint32_t id, std::shared_ptr<StackWithBonuses> previousState);
+
 	int32_t bonusTreeVersion;
 	int32_t activeUnitId;
 	mutable uint32_t nextId;
 
+	uint32_t currentRevision;
+	uint32_t lastRevision;
+	std::vector<Savepoint> savepoints;
+	std::vector<UnitUndoRecord> undoLog;
+
 	std::unique_ptr<HypotheticServerCallback> serverCallback;
 	std::unique_ptr<HypotheticEnvironment> localEnvironment;
 
@@ -230,4 +264,6 @@ private:
 	mutable std::shared_ptr<scripting::Pool> pool;
 #endif
 	mutable std::shared_ptr<events::EventBus> eventBus;
+
+	events::EventBus * getEventBus() const;
 };
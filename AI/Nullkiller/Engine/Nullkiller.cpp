@@ -197,6 +197,11 @@ Goals::TTaskVec Nullkiller::buildPlan(TGoalVec & tasks) const
 }
 
 void Nullkiller::decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, int decompositionMaxDepth) const
+{
+	decompose(result, behavior, decompositionMaxDepth, *decomposer);
+}
+
+void Nullkiller::decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, int decompositionMaxDepth, DeepDecomposer & behaviorDecomposer) const
 {
 	boost::this_thread::interruption_point();
 
@@ -204,7 +209,7 @@ void Nullkiller::decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, i
 
 	auto start = std::chrono::high_resolution_clock::now();
 	
-	decomposer->decompose(result, behavior, decompositionMaxDepth);
+	behaviorDecomposer.decompose(result, behavior, decompositionMaxDepth);
 
 	boost::this_thread::interruption_point();
 
@@ -214,6 +219,32 @@ void Nullkiller::decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, i
 		timeElapsed(start));
 }
 
+void Nullkiller::decomposeParallel(Goals::TGoalVec & result, const std::vector<std::pair<Goals::TSubgoal, int>> & behaviors) const
+{
+	// behaviors only read ai state, so they can be decomposed independently.
+	// Each one gets own decomposer and result vector, results are merged in order of behaviors
+	std::vector<Goals::TGoalVec> behaviorResults(behaviors.size());
+
+	auto start = std::chrono::high_resolution_clock::now();
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, behaviors.size(), 1), [this, &behaviors, &behaviorResults](const tbb::blocked_range<size_t> & r)
+		{
+			for(size_t i = r.begin(); i != r.end(); i++)
+			{
+				DeepDecomposer behaviorDecomposer(this);
+
+				decompose(behaviorResults[i], behaviors[i].first, behaviors[i].second, behaviorDecomposer);
+			}
+		});
+
+	boost::this_thread::interruption_point();
+
+	for(auto & behaviorResult : behaviorResults)
+		vstd::concatenate(result, behaviorResult);
+
+	logAi->debug("Decomposition of %d behaviors. Time taken %ld", behaviors.size(), timeElapsed(start));
+}
+
 void Nullkiller::resetAiState()
 {
 	std::unique_lock lockGuard(aiStateMutex);
@@ -382,21 +413,25 @@ void Nullkiller::makeTurn()
 			}
 		}
 
-		decompose(bestTasks, sptr(RecruitHeroBehavior()), 1);
-		decompose(bestTasks, sptr(CaptureObjectsBehavior()), 1);
-		decompose(bestTasks, sptr(ClusterBehavior()), MAX_DEPTH);
-		decompose(bestTasks, sptr(DefenceBehavior()), MAX_DEPTH);
-		decompose(bestTasks, sptr(GatherArmyBehavior()), MAX_DEPTH);
-		decompose(bestTasks, sptr(StayAtTownBehavior()), MAX_DEPTH);
+		std::vector<std::pair<Goals::TSubgoal, int>> behaviors = {
+			{ sptr(RecruitHeroBehavior()), 1 },
+			{ sptr(CaptureObjectsBehavior()), 1 },
+			{ sptr(ClusterBehavior()), MAX_DEPTH },
+			{ sptr(DefenceBehavior()), MAX_DEPTH },
+			{ sptr(GatherArmyBehavior()), MAX_DEPTH },
+			{ sptr(StayAtTownBehavior()), MAX_DEPTH }
+		};
 
 		if(!isOpenMap())
-			decompose(bestTasks, sptr(ExplorationBehavior()), MAX_DEPTH);
+			behaviors.emplace_back(sptr(ExplorationBehavior()), MAX_DEPTH);
 
 		if(cb->getDate(Date::DAY) == 1 || heroManager->getHeroRoles().empty())
 		{
-			decompose(bestTasks, sptr(StartupBehavior()), 1);
+			behaviors.emplace_back(sptr(StartupBehavior()), 1);
 		}
 
+		decomposeParallel(bestTasks, behaviors);
+
 		auto selectedTasks = buildPlan(bestTasks);
 
 		logAi->debug("Decision madel in %ld", timeElapsed(start));
@@ -125,6 +125,8 @@ private:
 	void resetAiState();
 	void updateAiState(int pass, bool fast = false);
 	void decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, int decompositionMaxDepth) const;
+	void decompose(Goals::TGoalVec & result, Goals::TSubgoal behavior, int decompositionMaxDepth, DeepDecomposer & behaviorDecomposer) const;
+	void decomposeParallel(Goals::TGoalVec & result, const std::vector<std::pair<Goals::TSubgoal, int>> & behaviors) const;
 	Goals::TTask choseBestTask(Goals::TGoalVec & tasks) const;
 	Goals::TTaskVec buildPlan(Goals::TGoalVec & tasks) const;
 	bool executeTask(Goals::TTask task);
@@ -43,7 +43,9 @@
 #include "../lib/gameState/CGameState.h"
 #include "../lib/gameState/HighScore.h"
 #include "../lib/CPlayerState.h"
+#include "../lib/mapping/CMap.h"
 #include "../lib/mapping/CMapInfo.h"
+#include "../lib/mapping/TerrainChunkCache.h"
 #include "../lib/mapObjects/CGTownInstance.h"
 #include "../lib/mapObjects/MiscObjects.h"
 #include "../lib/modding/ModIncompatibility.h"
@@ -97,6 +99,7 @@ CServerHandler::CServerHandler()
 	: networkHandler(INetworkHandler::createHandler())
 	, lobbyClient(std::make_unique<GlobalLobbyClient>())
 	, gameChat(std::make_unique<GameChatHandler>())
+	, terrainChunkCache(std::make_unique<TerrainChunkCache>())
 	, threadNetwork(&CServerHandler::threadRunNetwork, this)
 	, state(EClientState::NONE)
 	, serverPort(0)
@@ -267,6 +270,7 @@ void CServerHandler::onConnectionEstablished(const NetworkConnectionPtr & netCon
 	logicConnection = std::make_shared<CConnection>(netConnection);
 	logicConnection->uuid = uuid;
 	logicConnection->enterLobbyConnectionMode();
+	logicConnection->setTerrainChunkCache(terrainChunkCache.get());
 	sendClientConnecting();
 }
 
@@ -628,6 +632,10 @@ void CServerHandler::startGameplay(VCMI_LIB_WRAP_NAMESPACE(CGameState) * gameSta
 	default:
 		throw std::runtime_error("Invalid mode");
 	}
+	gameState->map->storeTerrain(*terrainChunkCache);
+	// server only knows chunks that were cached before this game, update them for restarts and following games
+	sendCachedTerrainChunks();
+
 	// After everything initialized we can accept CPackToClient netpacks
 	logicConnection->enterGameplayConnectionMode(client->gameState());
 	setState(EClientState::GAMEPLAY);
@@ -962,3 +970,15 @@ bool CServerHandler::inGame() const
 {
 	return logicConnection != nullptr;
 }
+
+void CServerHandler::sendCachedTerrainChunks() const
+{
+	if(!serverAcceptsTerrainChunks || terrainChunkCache->empty())
+		return;
+
+	LobbyCachedTerrainChunks cachedChunks;
+	cachedChunks.hashes = terrainChunkCache->getHashes();
+	cachedChunks.generation = terrainChunkCache->getGeneration();
+	// sent directly since sendLobbyPack drops packs while game is starting
+	logicConnection->sendPack(cachedChunks);
+}
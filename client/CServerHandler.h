@@ -24,6 +24,7 @@ struct TurnTimerInfo;
 
 class CMapInfo;
 class CGameState;
+class TerrainChunkCache;
 struct ClientPlayer;
 struct CPackForLobby;
 struct CPackForClient;
@@ -102,6 +103,10 @@ class CServerHandler final : public IServerAPI, public LobbyInfo, public INetwor
 	std::unique_ptr<IServerRunner> serverRunner;
 	std::shared_ptr<CMapInfo> mapToStart;
 	std::vector<std::string> localPlayerNames;
+	/// Terrain of games started in this session, lets server skip sending terrain that did not change
+	std::unique_ptr<TerrainChunkCache> terrainChunkCache;
+	/// Server serialization version allows sending terrain chunks without static data
+	bool serverAcceptsTerrainChunks = false;
 
 	boost::thread threadNetwork;
 
@@ -165,6 +170,8 @@ public:
 	bool isGuest() const;
 	bool inLobbyRoom() const;
 	bool inGame() const;
+	/// Notifies server about chunks in terrain cache, so following game starts can skip them
+	void sendCachedTerrainChunks() const;
 
 	const std::string & getCurrentHostname() const;
 	const std::string & getLocalHostname() const;
@@ -224,6 +224,7 @@ void CClient::initMapHandler()
 	}
 
 	pathCache.clear();
+	outdatedPaths.clear();
 }
 
 void CClient::initPlayerEnvironments()
@@ -510,6 +511,7 @@ void CClient::updatePath(const CGHeroInstance * hero)
 void CClient::invalidatePaths()
 {
 	boost::unique_lock<boost::mutex> pathLock(pathCacheMutex);
+	outdatedPaths = std::move(pathCache);
 	pathCache.clear();
 }
 
@@ -529,7 +531,17 @@ std::shared_ptr<const CPathsInfo> CClient::getPathsInfo(const CGHeroInstance * h
 
 	if(iter == std::end(pathCache))
 	{
-		auto paths = std::make_shared<CPathsInfo>(getMapSize(), h);
+		std::shared_ptr<CPathsInfo> paths;
+		auto outdated = outdatedPaths.find(h);
+
+		// previous paths can be reused only if nobody is reading them anymore
+		if(outdated != std::end(outdatedPaths) && outdated->second.use_count() == 1)
+			paths = outdated->second;
+		else
+			paths = std::make_shared<CPathsInfo>(getMapSize(), h);
+
+		if(outdated != std::end(outdatedPaths))
+			outdatedPaths.erase(outdated);
 
 		gs->calculatePaths(h, *paths.get());
 
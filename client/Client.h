@@ -237,6 +237,7 @@ private:
 
 	mutable boost::mutex pathCacheMutex;
 	std::map<const CGHeroInstance *, std::shared_ptr<CPathsInfo>> pathCache;
+	std::map<const CGHeroInstance *, std::shared_ptr<CPathsInfo>> outdatedPaths; // invalidated paths, can be updated instead of full recalculation
 
 	void reinitScripting();
 };
@@ -309,13 +309,13 @@ void ClientCommandManager::handleGetConfigCommand()
 
 		for(auto& iter : content.modData)
 		{
-			const JsonNode& modData = iter.second.modData;
+			const CompactJsonView modData = iter.second.modData.root();
 
-			for(auto& nameAndObject : modData.Struct())
+			for(size_t i = 0; i < modData.size(); ++i)
 			{
-				const JsonNode& object = nameAndObject.second;
+				const JsonNode object = modData.valueAt(i).toJsonNode();
 
-				std::string name = ModUtility::makeFullIdentifier(object.getModScope(), contentName, nameAndObject.first);
+				std::string name = ModUtility::makeFullIdentifier(object.getModScope(), contentName, modData.keyAt(i));
 
 				boost::algorithm::replace_all(name, ":", "_");
 
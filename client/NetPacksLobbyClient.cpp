@@ -39,6 +39,8 @@
 #include "../lib/texts/CGeneralTextHandler.h"
 #include "../lib/serializer/Connection.h"
 #include "../lib/campaign/CampaignState.h"
+#include "../lib/mapping/TerrainChunkCache.h"
+#include "../lib/serializer/ESerializationVersion.h"
 
 void ApplyOnLobbyHandlerNetPackVisitor::visitLobbyClientConnected(LobbyClientConnected & pack)
 {
@@ -49,6 +51,9 @@ void ApplyOnLobbyHandlerNetPackVisitor::visitLobbyClientConnected(LobbyClientCon
 	{
 		handler.logicConnection->setSerializationVersion(pack.version);
 		handler.logicConnection->connectionID = pack.clientId;
+
+		handler.serverAcceptsTerrainChunks = pack.version >= ESerializationVersion::TERRAIN_CHUNKS;
+		handler.sendCachedTerrainChunks();
 		if(handler.mapToStart)
 		{
 			handler.setMapInfo(handler.mapToStart);
@@ -199,6 +204,12 @@ void ApplyOnLobbyHandlerNetPackVisitor::visitLobbyUpdateState(LobbyUpdateState &
 	}
 }
 
+void ApplyOnLobbyHandlerNetPackVisitor::visitLobbyCachedTerrainChunksAccepted(LobbyCachedTerrainChunksAccepted & pack)
+{
+	handler.terrainChunkCache->prune(pack.generation);
+	result = false;
+}
+
 void ApplyOnLobbyScreenNetPackVisitor::visitLobbyUpdateState(LobbyUpdateState & pack)
 {
 	if(!lobby) //stub: ignore message for game mode
@@ -1071,92 +1071,80 @@ ReachabilityInfo CBattleInfoCallback::makeBFS(const AccessibilityInfo &accessibi
 	if(!params.startPosition.isValid()) //if got call for arrow turrets
 		return ret;
 
-	const std::set<BattleHex> obstacles = getStoppers(params.perspective);
-	auto checkParams = params;
-	checkParams.ignoreKnownAccessible = true; //Ignore starting hexes obstacles
-
-	std::queue<BattleHex> hexq; //bfs queue
-
-	//first element
-	hexq.push(params.startPosition);
-	ret.distances[params.startPosition] = 0;
+	// walking stack can't step past the obstacles, but obstacles in starting hexes are ignored
+	THexMask obstacles = getStoppers(params.perspective);
+	for(auto hex : params.knownAccessible)
+		if(hex.isValid())
+			obstacles.reset(hex.hex);
 
-	std::array<bool, GameConstants::BFIELD_SIZE> accessibleCache{};
-	for(int hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
-		accessibleCache[hex] = accessibility.accessible(hex, params.doubleWide, params.side);
+	// drawbridge only stops attackers, and only if gate is not destroyed
+	if(battleGetGateState() == EGateState::DESTROYED || params.side != BattleSide::ATTACKER)
+		obstacles.reset(BattleHex::GATE_BRIDGE);
 
-	while(!hexq.empty()) //bfs loop
+	const auto & isInObstacle = [&obstacles, &params](BattleHex hex)
 	{
-		const BattleHex curHex = hexq.front();
-		hexq.pop();
-
-		//walking stack can't step past the obstacles
-		if(isInObstacle(curHex, obstacles, checkParams))
-			continue;
-
-		const int costToNeighbour = ret.distances.at(curHex.hex) + 1;
-
-		for(BattleHex neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
-		{
-			if(neighbour.isValid())
-			{
-				auto additionalCost = 0;
+		if(obstacles.test(hex.hex))
+			return true;
 
-				if(params.bypassEnemyStacks)
-				{
-					auto enemyToBypass = params.destructibleEnemyTurns.find(neighbour);
+		if(!params.doubleWide)
+			return false;
 
-					if(enemyToBypass != params.destructibleEnemyTurns.end())
-					{
-						additionalCost = enemyToBypass->second;
-					}
-				}
+		BattleHex otherHex = battle::Unit::occupiedHex(hex, params.doubleWide, params.side);
+		return otherHex.isValid() && obstacles.test(otherHex.hex);
+	};
 
-				const int costFoundSoFar = ret.distances[neighbour.hex];
+	THexMask accessibleHexes;
+	for(int hex = 0; hex < GameConstants::BFIELD_SIZE; hex++)
+		accessibleHexes[hex] = accessibility.accessible(hex, params.doubleWide, params.side);
 
-				if(accessibleCache[neighbour.hex] && costToNeighbour + additionalCost < costFoundSoFar)
-				{
-					hexq.push(neighbour);
-					ret.distances[neighbour.hex] = costToNeighbour + additionalCost;
-					ret.predecessors[neighbour.hex] = curHex;
-				}
-			}
-		}
+	std::array<ui8, GameConstants::BFIELD_SIZE> additionalCosts{};
+	if(params.bypassEnemyStacks)
+	{
+		for(const auto & [hex, turns] : params.destructibleEnemyTurns)
+			if(hex.isValid())
+				additionalCosts[hex.hex] = turns;
 	}
 
-	return ret;
-}
+	// bfs queue. Hexes may be queued again if cheaper path was found through destructible enemy, so elements are never removed
+	std::vector<BattleHex> hexq;
+	hexq.reserve(GameConstants::BFIELD_SIZE * 2);
 
-bool CBattleInfoCallback::isInObstacle(
-	BattleHex hex,
-	const std::set<BattleHex> & obstacles,
-	const ReachabilityInfo::Parameters & params) const
-{
-	auto occupiedHexes = battle::Unit::getHexes(hex, params.doubleWide, params.side);
+	//first element
+	hexq.push_back(params.startPosition);
+	ret.distances[params.startPosition] = 0;
 
-	for(auto occupiedHex : occupiedHexes)
+	for(size_t queuePosition = 0; queuePosition < hexq.size(); ++queuePosition) //bfs loop
 	{
-		if(params.ignoreKnownAccessible && vstd::contains(params.knownAccessible, occupiedHex))
+		const BattleHex curHex = hexq[queuePosition];
+
+		//walking stack can't step past the obstacles
+		if(isInObstacle(curHex))
 			continue;
 
-		if(vstd::contains(obstacles, occupiedHex))
+		const int costToNeighbour = ret.distances[curHex.hex] + 1;
+
+		for(BattleHex neighbour : BattleHex::neighbouringTilesCache[curHex.hex])
 		{
-			if(occupiedHex == BattleHex::GATE_BRIDGE)
+			if(!neighbour.isValid() || !accessibleHexes.test(neighbour.hex))
+				continue;
+
+			const int costToThisNeighbour = costToNeighbour + additionalCosts[neighbour.hex];
+
+			if(costToThisNeighbour < static_cast<int>(ret.distances[neighbour.hex]))
 			{
-				if(battleGetGateState() != EGateState::DESTROYED && params.side == BattleSide::ATTACKER)
-					return true;
+				hexq.push_back(neighbour);
+				ret.distances[neighbour.hex] = costToThisNeighbour;
+				ret.predecessors[neighbour.hex] = curHex;
 			}
-			else
-				return true;
 		}
 	}
 
-	return false;
+	return ret;
 }
 
-std::set<BattleHex> CBattleInfoCallback::getStoppers(BattleSide whichSidePerspective) const
+CBattleInfoCallback::THexMask CBattleInfoCallback::getStoppers(BattleSide whichSidePerspective) const
 {
-	std::set<BattleHex> ret;
+	THexMask ret;
 	RETURN_IF_NOT_BATTLE(ret);
 
 	for(auto &oi : battleGetAllObstacles(whichSidePerspective))
@@ -1171,7 +1159,8 @@ std::set<BattleHex> CBattleInfoCallback::getStoppers(BattleSide whichSidePerspec
 				if(battleGetGateState() == EGateState::OPENED || battleGetGateState() == EGateState::DESTROYED)
 					continue; // this tile is disabled by drawbridge on top of it
 			}
-			ret.insert(hex);
+			if(hex.isValid())
+				ret.set(hex.hex);
 		}
 	}
 	return ret;
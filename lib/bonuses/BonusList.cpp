@@ -14,19 +14,19 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-BonusList::BonusList(bool BelongsToTree) : belongsToTree(BelongsToTree)
+BonusList::BonusList(const CBonusSystemNode * Owner) : owner(Owner)
 {
 }
 
-BonusList::BonusList(const BonusList & bonusList): belongsToTree(false)
+BonusList::BonusList(const BonusList & bonusList): owner(nullptr)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
 }
 
-BonusList::BonusList(BonusList && other) noexcept: belongsToTree(false)
+BonusList::BonusList(BonusList && other) noexcept: owner(nullptr)
 {
-	std::swap(belongsToTree, other.belongsToTree);
+	std::swap(owner, other.owner);
 	std::swap(bonuses, other.bonuses);
 }
 
@@ -34,14 +34,14 @@ BonusList& BonusList::operator=(const BonusList &bonusList)
 {
 	bonuses.resize(bonusList.size());
 	std::copy(bonusList.begin(), bonusList.end(), bonuses.begin());
-	belongsToTree = false;
+	owner = nullptr;
 	return *this;
 }
 
 void BonusList::changed() const
 {
-    if(belongsToTree)
-		CBonusSystemNode::treeHasChanged();
+	if(owner)
+		owner->nodeHasChanged();
 }
 
 void BonusList::stackBonuses()
@@ -14,6 +14,8 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+class CBonusSystemNode;
+
 class DLL_LINKAGE BonusList
 {
 public:
@@ -21,7 +23,7 @@ public:
 
 private:
 	TInternalContainer bonuses;
-	bool belongsToTree;
+	const CBonusSystemNode * owner; // node that is notified on changes, null for detached lists
 	void changed() const;
 
 public:
@@ -31,7 +33,7 @@ public:
 	using const_iterator = TInternalContainer::const_iterator;
 	using iterator = TInternalContainer::iterator;
 
-	BonusList(bool BelongsToTree = false);
+	BonusList(const CBonusSystemNode * Owner = nullptr);
 	BonusList(const BonusList &bonusList);
 	BonusList(BonusList && other) noexcept;
 	BonusList& operator=(const BonusList &bonusList);
@@ -13,6 +13,310 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+bool CSelector::Instruction::operator==(const Instruction & other) const
+{
+	return operation == other.operation
+		&& field == other.field
+		&& size == other.size
+		&& value == other.value
+		&& function == other.function;
+}
+
+CSelector::CSelector(TProgram && newProgram)
+{
+	for(const auto & instruction : newProgram)
+	{
+		boost::hash_combine(programHash, static_cast<int>(instruction.operation));
+		boost::hash_combine(programHash, static_cast<int>(instruction.field));
+		boost::hash_combine(programHash, instruction.size);
+		boost::hash_combine(programHash, instruction.value);
+
+		if(instruction.function)
+		{
+			boost::hash_combine(programHash, instruction.function.get());
+			cacheable = false;
+		}
+	}
+
+	program = std::make_shared<const TProgram>(std::move(newProgram));
+}
+
+CSelector::CSelector(const Instruction & instruction)
+	: CSelector(TProgram{instruction})
+{
+}
+
+CSelector::CSelector(std::shared_ptr<const TFunction> function)
+{
+	if(!function || !*function)
+		return;
+
+	Instruction instruction;
+	instruction.operation = EOperation::FUNCTION;
+	instruction.function = std::move(function);
+	*this = CSelector(instruction);
+}
+
+CSelector::CSelector(bool (*function)(const Bonus *))
+{
+	static const std::vector<std::pair<bool (*)(const Bonus *), BonusDuration::Type>> durationChecks = {
+		{ Bonus::NDays, BonusDuration::N_DAYS },
+		{ Bonus::NTurns, BonusDuration::N_TURNS },
+		{ Bonus::OneDay, BonusDuration::ONE_DAY },
+		{ Bonus::OneWeek, BonusDuration::ONE_WEEK },
+		{ Bonus::OneBattle, BonusDuration::ONE_BATTLE },
+		{ Bonus::Permanent, BonusDuration::PERMANENT },
+		{ Bonus::UntilGetsTurn, BonusDuration::STACK_GETS_TURN },
+		{ Bonus::UntilAttack, BonusDuration::UNTIL_ATTACK },
+		{ Bonus::UntilBeingAttacked, BonusDuration::UNTIL_BEING_ATTACKED },
+		{ Bonus::UntilCommanderKilled, BonusDuration::COMMANDER_KILLED },
+		{ Bonus::UntilOwnAttack, BonusDuration::UNTIL_OWN_ATTACK },
+	};
+
+	if(!function)
+		return;
+
+	for(const auto & check : durationChecks)
+	{
+		if(check.first == function)
+		{
+			*this = durationMask(check.second);
+			return;
+		}
+	}
+
+	// functions from other libraries may have different address, keep them as functors
+	*this = CSelector(std::make_shared<const TFunction>(function));
+}
+
+CSelector CSelector::fieldEqual(EField field, int64_t value)
+{
+	Instruction instruction;
+	instruction.operation = EOperation::FIELD_EQUAL;
+	instruction.field = field;
+	instruction.value = value;
+	return CSelector(instruction);
+}
+
+CSelector CSelector::durationMask(BonusDuration::Type mask)
+{
+	Instruction instruction;
+	instruction.operation = EOperation::DURATION;
+	instruction.value = mask;
+	return CSelector(instruction);
+}
+
+CSelector CSelector::constant(bool value)
+{
+	Instruction instruction;
+	instruction.operation = value ? EOperation::ALL : EOperation::NONE;
+	return CSelector(instruction);
+}
+
+void CSelector::appendOperand(TProgram & result, EOperation operation) const
+{
+	assert(program);
+
+	// a && (b && c) is stored as single AND with three operands to keep program flat
+	if(program->front().operation == operation)
+		result.insert(result.end(), program->begin() + 1, program->end());
+	else
+		result.insert(result.end(), program->begin(), program->end());
+}
+
+CSelector CSelector::combine(EOperation operation, const CSelector & rhs) const
+{
+	assert(program && rhs.program);
+
+	// operation that decides result on its own: NONE for AND, ALL for OR
+	EOperation absorbing = operation == EOperation::AND ? EOperation::NONE : EOperation::ALL;
+	// operation that has no effect on result: ALL for AND, NONE for OR
+	EOperation neutral = operation == EOperation::AND ? EOperation::ALL : EOperation::NONE;
+
+	EOperation lhsRoot = program->front().operation;
+	EOperation rhsRoot = rhs.program->front().operation;
+
+	if(lhsRoot == absorbing || rhsRoot == neutral)
+		return *this;
+	if(rhsRoot == absorbing || lhsRoot == neutral)
+		return rhs;
+
+	TProgram result;
+	result.reserve(program->size() + rhs.program->size() + 1);
+	result.emplace_back();
+	appendOperand(result, operation);
+	rhs.appendOperand(result, operation);
+
+	result.front().operation = operation;
+	result.front().size = static_cast<uint32_t>(result.size());
+	return CSelector(std::move(result));
+}
+
+CSelector CSelector::And(const CSelector & rhs) const
+{
+	return combine(EOperation::AND, rhs);
+}
+
+CSelector CSelector::Or(const CSelector & rhs) const
+{
+	return combine(EOperation::OR, rhs);
+}
+
+CSelector CSelector::Not() const
+{
+	assert(program);
+
+	switch(program->front().operation)
+	{
+	case EOperation::ALL:
+		return constant(false);
+	case EOperation::NONE:
+		return constant(true);
+	case EOperation::NOT:
+		return CSelector(TProgram(program->begin() + 1, program->end()));
+	}
+
+	TProgram result;
+	result.reserve(program->size() + 1);
+	result.emplace_back();
+	result.front().operation = EOperation::NOT;
+	result.front().size = static_cast<uint32_t>(program->size() + 1);
+	result.insert(result.end(), program->begin(), program->end());
+	return CSelector(std::move(result));
+}
+
+bool CSelector::operator==(const CSelector & other) const
+{
+	if(program == other.program)
+		return true;
+	if(!program || !other.program || programHash != other.programHash)
+		return false;
+	return *program == *other.program;
+}
+
+std::optional<BonusType> CSelector::requiredType() const
+{
+	if(!program)
+		return std::nullopt;
+
+	const Instruction & root = program->front();
+
+	if(root.operation == EOperation::FIELD_EQUAL && root.field == EField::TYPE)
+		return static_cast<BonusType>(root.value);
+
+	if(root.operation == EOperation::AND)
+	{
+		const Instruction * end = program->data() + root.size;
+		for(const Instruction * operand = program->data() + 1; operand != end; operand += operand->size)
+			if(operand->operation == EOperation::FIELD_EQUAL && operand->field == EField::TYPE)
+				return static_cast<BonusType>(operand->value);
+	}
+
+	return std::nullopt;
+}
+
+bool CSelector::evaluate(const Instruction * instruction, const Bonus * bonus)
+{
+	switch(instruction->operation)
+	{
+	case EOperation::ALL:
+		return true;
+	case EOperation::NONE:
+		return false;
+	case EOperation::FIELD_EQUAL:
+		return fieldValue(bonus, instruction->field) == instruction->value;
+	case EOperation::DURATION:
+		return (bonus->duration & instruction->value) != 0;
+	case EOperation::FUNCTION:
+		return (*instruction->function)(bonus);
+	case EOperation::NOT:
+		return !evaluate(instruction + 1, bonus);
+	case EOperation::AND:
+	{
+		const Instruction * end = instruction + instruction->size;
+		for(const Instruction * operand = instruction + 1; operand != end; operand += operand->size)
+			if(!evaluate(operand, bonus))
+				return false;
+		return true;
+	}
+	case EOperation::OR:
+	{
+		const Instruction * end = instruction + instruction->size;
+		for(const Instruction * operand = instruction + 1; operand != end; operand += operand->size)
+			if(evaluate(operand, bonus))
+				return true;
+		return false;
+	}
+	}
+	throw std::runtime_error("Invalid bonus selector operation!");
+}
+
+int64_t CSelector::fieldValue(const Bonus * bonus, EField field)
+{
+	switch(field)
+	{
+	case EField::TYPE:
+		return encode(bonus->type);
+	case EField::SUBTYPE:
+		return encode(bonus->subtype);
+	case EField::SOURCE:
+		return encode(bonus->source);
+	case EField::SOURCE_ID:
+		return encode(bonus->sid);
+	case EField::TARGET_SOURCE:
+		return encode(bonus->targetSourceType);
+	case EField::VALUE_TYPE:
+		return encode(bonus->valType);
+	case EField::EFFECT_RANGE:
+		return encode(bonus->effectRange);
+	}
+	throw std::runtime_error("Invalid bonus selector field!");
+}
+
+std::optional<CSelector::EField> CSelector::fieldOf(BonusType Bonus::*ptr)
+{
+	if(ptr == &Bonus::type)
+		return EField::TYPE;
+	return std::nullopt;
+}
+
+std::optional<CSelector::EField> CSelector::fieldOf(BonusSubtypeID Bonus::*ptr)
+{
+	if(ptr == &Bonus::subtype)
+		return EField::SUBTYPE;
+	return std::nullopt;
+}
+
+std::optional<CSelector::EField> CSelector::fieldOf(BonusSource Bonus::*ptr)
+{
+	if(ptr == &Bonus::source)
+		return EField::SOURCE;
+	if(ptr == &Bonus::targetSourceType)
+		return EField::TARGET_SOURCE;
+	return std::nullopt;
+}
+
+std::optional<CSelector::EField> CSelector::fieldOf(BonusSourceID Bonus::*ptr)
+{
+	if(ptr == &Bonus::sid)
+		return EField::SOURCE_ID;
+	return std::nullopt;
+}
+
+std::optional<CSelector::EField> CSelector::fieldOf(BonusValueType Bonus::*ptr)
+{
+	if(ptr == &Bonus::valType)
+		return EField::VALUE_TYPE;
+	return std::nullopt;
+}
+
+std::optional<CSelector::EField> CSelector::fieldOf(BonusLimitEffect Bonus::*ptr)
+{
+	if(ptr == &Bonus::effectRange)
+		return EField::EFFECT_RANGE;
+	return std::nullopt;
+}
+
 namespace Selector
 {
 	DLL_LINKAGE const CSelectFieldEqual<BonusType> & type()
@@ -96,8 +400,8 @@ namespace Selector
 				.And(valueType(valType));
 	}
 
-	DLL_LINKAGE CSelector all([](const Bonus * b){return true;});
-	DLL_LINKAGE CSelector none([](const Bonus * b){return false;});
+	DLL_LINKAGE CSelector all = CSelector::constant(true);
+	DLL_LINKAGE CSelector none = CSelector::constant(false);
 }
 
 VCMI_LIB_NAMESPACE_END
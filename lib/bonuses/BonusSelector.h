@@ -14,48 +14,150 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-class CSelector : std::function<bool(const Bonus*)>
+/// Predicate that tests if Bonus matches some criteria
+/// Selectors built from bonus fields (type, subtype, source, duration...) and their combinations are stored
+/// as flat program that is evaluated without indirect calls and can be hashed and compared, which allows
+/// caching of bonus queries without any additional information from caller.
+/// Arbitrary functors are supported as well, but such selectors can not be compared with each other
+class DLL_LINKAGE CSelector
 {
-	using TBase = std::function<bool(const Bonus*)>;
+public:
+	using TFunction = std::function<bool(const Bonus*)>;
+
+	/// Bonus fields that can be tested by selector without calling into functor
+	enum class EField : uint8_t
+	{
+		TYPE,
+		SUBTYPE,
+		SOURCE,
+		SOURCE_ID,
+		TARGET_SOURCE,
+		VALUE_TYPE,
+		EFFECT_RANGE
+	};
+
+private:
+	enum class EOperation : uint8_t
+	{
+		ALL,
+		NONE,
+		AND,
+		OR,
+		NOT,
+		FIELD_EQUAL,
+		DURATION,
+		FUNCTION
+	};
+
+	struct Instruction
+	{
+		EOperation operation = EOperation::ALL;
+		EField field = EField::TYPE;
+		uint32_t size = 1; // number of instructions in subtree of this instruction, including itself
+		int64_t value = 0; // encoded field value or duration mask
+		std::shared_ptr<const TFunction> function; // only for FUNCTION operation
+
+		bool operator==(const Instruction & other) const;
+	};
+
+	using TProgram = std::vector<Instruction>;
+
+	std::shared_ptr<const TProgram> program;
+	size_t programHash = 0;
+	bool cacheable = true;
+
+	explicit CSelector(TProgram && program);
+	explicit CSelector(const Instruction & instruction);
+
+	CSelector combine(EOperation operation, const CSelector & rhs) const;
+	void appendOperand(TProgram & result, EOperation operation) const;
+
+	static bool evaluate(const Instruction * instruction, const Bonus * bonus);
+	static int64_t fieldValue(const Bonus * bonus, EField field);
+
+	static std::optional<EField> fieldOf(BonusType Bonus::*ptr);
+	static std::optional<EField> fieldOf(BonusSubtypeID Bonus::*ptr);
+	static std::optional<EField> fieldOf(BonusSource Bonus::*ptr);
+	static std::optional<EField> fieldOf(BonusSourceID Bonus::*ptr);
+	static std::optional<EField> fieldOf(BonusValueType Bonus::*ptr);
+	static std::optional<EField> fieldOf(BonusLimitEffect Bonus::*ptr);
+	template<typename T>
+	static std::optional<EField> fieldOf(T Bonus::*ptr)
+	{
+		return std::nullopt;
+	}
+
+	template<typename T>
+	static int64_t encode(const T & value)
+	{
+		return static_cast<int64_t>(value);
+	}
+
+	template<typename... Types>
+	static int64_t encode(const VariantIdentifier<Types...> & value)
+	{
+		return (static_cast<int64_t>(value.getTypeIndex()) << 32) | static_cast<uint32_t>(value.getNum());
+	}
+
+	template<typename T>
+	friend class CSelectFieldEqual;
+
 public:
 	CSelector() = default;
 	template<typename T>
 	CSelector(const T &t,	//SFINAE trick -> include this c-tor in overload resolution only if parameter is class
-							//(includes functors, lambdas) or function. Without that VC is going mad about ambiguities.
-		typename std::enable_if_t < std::is_class_v<T> || std::is_function_v<T> > *dummy = nullptr)
-		: TBase(t)
+							//(includes functors, lambdas). Without that VC is going mad about ambiguities.
+		typename std::enable_if_t < std::is_class_v<T> && !std::is_same_v<T, CSelector> > *dummy = nullptr)
+		: CSelector(std::make_shared<const TFunction>(t))
 	{}
 
+	/// Plain functions, such as duration checks from Bonus, are converted to compiled form if possible
+	CSelector(bool (*function)(const Bonus *));
+	CSelector(std::shared_ptr<const TFunction> function);
+
 	CSelector(std::nullptr_t)
 	{}
 
-	CSelector And(CSelector rhs) const
+	CSelector And(const CSelector & rhs) const;
+	CSelector Or(const CSelector & rhs) const;
+	CSelector Not() const;
+
+	bool operator()(const Bonus *b) const
 	{
-		//lambda may likely outlive "this" (it can be even a temporary) => we copy the OBJECT (not pointer)
-		auto thisCopy = *this;
-		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) && rhs(b); };
+		if(!program)
+			throw std::bad_function_call();
+		return evaluate(program->data(), b);
 	}
-	CSelector Or(CSelector rhs) const
+
+	operator bool() const
 	{
-		auto thisCopy = *this;
-		return [thisCopy, rhs](const Bonus *b) mutable { return thisCopy(b) || rhs(b); };
+		return program != nullptr;
 	}
 
-	CSelector Not() const
+	/// Returns true if selector consists only of bonus field checks, so its hash and comparison can identify query
+	bool isCacheable() const
 	{
-		auto thisCopy = *this;
-		return [thisCopy](const Bonus *b) mutable { return !thisCopy(b); };
+		return cacheable;
 	}
 
-	bool operator()(const Bonus *b) const
+	size_t hash() const
 	{
-		return TBase::operator()(b);
+		return programHash;
 	}
 
-	operator bool() const
+	/// Returns bonus type that every selected bonus must have, if selector restricts it
+	std::optional<BonusType> requiredType() const;
+
+	bool operator==(const CSelector & other) const;
+
+	friend size_t hash_value(const CSelector & selector)
 	{
-		return !!static_cast<const TBase&>(*this);
+		return selector.hash();
 	}
+
+	static CSelector fieldEqual(EField field, int64_t value);
+	static CSelector durationMask(BonusDuration::Type mask);
+	static CSelector constant(bool value);
 };
 
 template<typename T>
@@ -71,6 +173,13 @@ public:
 
 	CSelector operator()(const T &valueToCompareAgainst) const
 	{
+		if constexpr(std::is_enum_v<T> || std::is_same_v<T, BonusSubtypeID> || std::is_same_v<T, BonusSourceID>)
+		{
+			auto field = CSelector::fieldOf(ptr);
+			if(field)
+				return CSelector::fieldEqual(*field, CSelector::encode(valueToCompareAgainst));
+		}
+
 		auto ptr2 = ptr; //We need a COPY because we don't want to reference this (might be outlived by lambda)
 		return [ptr2, valueToCompareAgainst](const Bonus *bonus)
 		{
@@ -18,8 +18,30 @@
 VCMI_LIB_NAMESPACE_BEGIN
 
 std::atomic<int64_t> CBonusSystemNode::treeChanged(1);
+std::atomic<int64_t> CBonusSystemNode::invalidationCounter(1);
 constexpr bool CBonusSystemNode::cachingEnabled = true;
 
+namespace
+{
+struct BonusTypeComparator
+{
+	bool operator()(const std::shared_ptr<Bonus> & left, const std::shared_ptr<Bonus> & right) const
+	{
+		return left->type < right->type;
+	}
+
+	bool operator()(const std::shared_ptr<Bonus> & left, BonusType right) const
+	{
+		return left->type < right;
+	}
+
+	bool operator()(BonusType left, const std::shared_ptr<Bonus> & right) const
+	{
+		return left < right->type;
+	}
+};
+}
+
 std::shared_ptr<Bonus> CBonusSystemNode::getLocalBonus(const CSelector & selector)
 {
 	auto ret = bonuses.getFirst(selector);
@@ -114,21 +136,40 @@ TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, co
 		// Exclusive access for one thread
 		boost::lock_guard<boost::mutex> lock(sync);
 
-		// If the bonus system tree changes(state of a single node or the relations to each other) then
+		// If this node or any of its ancestors changed (state of a single node or the relations to each other) then
 		// cache all bonus objects. Selector objects doesn't matter.
-		if (cachedLast != treeChanged)
+		const int64_t treeVersion = getTreeVersion();
+		if (cachedLast != treeVersion)
 		{
 			BonusList allBonuses;
 			allBonuses.reserve(cachedBonuses.capacity()); //we assume we'll get about the same number of bonuses
 
 			cachedBonuses.clear();
 			cachedRequests.clear();
+			cachedSelectorRequests.clear();
 
 			getAllBonusesRec(allBonuses, Selector::all);
 			limitBonuses(allBonuses, cachedBonuses);
 			cachedBonuses.stackBonuses();
 
-			cachedLast = treeChanged;
+			cachedBonusesByType.assign(cachedBonuses.begin(), cachedBonuses.end());
+			std::stable_sort(cachedBonusesByType.begin(), cachedBonusesByType.end(), BonusTypeComparator());
+
+			cachedLast = treeVersion;
+		}
+
+		// Selectors that consist only of bonus field checks can be used as cache key directly
+		if(selector.isCacheable() && limit.isCacheable())
+		{
+			auto key = std::make_pair(selector, limit);
+			auto it = cachedSelectorRequests.find(key);
+			if(it != cachedSelectorRequests.end())
+				return it->second;
+
+			auto ret = std::make_shared<BonusList>();
+			getCachedBonuses(*ret, selector, limit);
+			cachedSelectorRequests[key] = ret;
+			return ret;
 		}
 
 		// If a bonus system request comes with a caching string then look up in the map if there are any
@@ -146,7 +187,7 @@ TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, co
 		//We still don't have the bonuses (didn't returned them from cache)
 		//Perform bonus selection
 		auto ret = std::make_shared<BonusList>();
-		cachedBonuses.getBonuses(*ret, selector, limit);
+		getCachedBonuses(*ret, selector, limit);
 
 		// Save the results in the cache
 		if(!cachingStr.empty())
@@ -160,6 +201,27 @@ TConstBonusListPtr CBonusSystemNode::getAllBonuses(const CSelector &selector, co
 	}
 }
 
+void CBonusSystemNode::getCachedBonuses(BonusList & out, const CSelector & selector, const CSelector & limit) const
+{
+	auto type = selector.requiredType();
+
+	if(!type)
+	{
+		cachedBonuses.getBonuses(out, selector, limit);
+		return;
+	}
+
+	// only bonuses of requested type need to be checked
+	auto range = std::equal_range(cachedBonusesByType.begin(), cachedBonusesByType.end(), *type, BonusTypeComparator());
+
+	out.reserve(std::distance(range.first, range.second));
+	for(auto it = range.first; it != range.second; ++it)
+	{
+		if(selector(it->get()) && (!limit || limit(it->get())))
+			out.push_back(*it);
+	}
+}
+
 TConstBonusListPtr CBonusSystemNode::getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit) const
 {
 	auto ret = std::make_shared<BonusList>();
@@ -181,19 +243,21 @@ std::shared_ptr<Bonus> CBonusSystemNode::getUpdatedBonus(const std::shared_ptr<B
 }
 
 CBonusSystemNode::CBonusSystemNode(bool isHypotetic):
-	bonuses(true),
-	exportedBonuses(true),
+	bonuses(this),
+	exportedBonuses(this),
 	nodeType(UNKNOWN),
 	cachedLast(0),
+	nodeChanged(0),
 	isHypotheticNode(isHypotetic)
 {
 }
 
 CBonusSystemNode::CBonusSystemNode(ENodeTypes NodeType):
-	bonuses(true),
-	exportedBonuses(true),
+	bonuses(this),
+	exportedBonuses(this),
 	nodeType(NodeType),
 	cachedLast(0),
+	nodeChanged(0),
 	isHypotheticNode(false)
 {
 }
@@ -224,7 +288,7 @@ void CBonusSystemNode::attachTo(CBonusSystemNode & parent)
 		parent.newChildAttached(*this);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::attachToSource(const CBonusSystemNode & parent)
@@ -234,11 +298,13 @@ void CBonusSystemNode::attachToSource(const CBonusSystemNode & parent)
 
 	if(!isHypothetic())
 	{
+		parent.inheritingNodes.push_back(this);
+
 		if(parent.actsAsBonusSourceOnly())
 			parent.newRedDescendant(*this);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::detachFrom(CBonusSystemNode & parent)
@@ -267,7 +333,7 @@ void CBonusSystemNode::detachFrom(CBonusSystemNode & parent)
 	{
 		parent.childDetached(*this);
 	}
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 
@@ -291,7 +357,10 @@ void CBonusSystemNode::detachFromSource(const CBonusSystemNode & parent)
 			, nodeShortInfo(), nodeType, parent.nodeShortInfo(), parent.nodeType);
 	}
 
-	CBonusSystemNode::treeHasChanged();
+	if(!isHypothetic())
+		parent.inheritingNodes -= this;
+
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::removeBonusesRecursive(const CSelector & s)
@@ -327,7 +396,7 @@ void CBonusSystemNode::addNewBonus(const std::shared_ptr<Bonus>& b)
 	assert(!vstd::contains(exportedBonuses, b));
 	exportedBonuses.push_back(b);
 	exportBonus(b);
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::accumulateBonus(const std::shared_ptr<Bonus>& b)
@@ -346,7 +415,7 @@ void CBonusSystemNode::removeBonus(const std::shared_ptr<Bonus>& b)
 		unpropagateBonus(b);
 	else
 		bonuses -= b;
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::removeBonuses(const CSelector & selector)
@@ -396,11 +465,11 @@ void CBonusSystemNode::unpropagateBonus(const std::shared_ptr<Bonus> & b)
 		else
 			logBonus->warn("Attempt to remove #$# %s, which is not propagated to %s", b->Description(), nodeName());
 
-		bonuses.remove_if([b](const auto & bonus)
+		bonuses.remove_if([this, b](const auto & bonus)
 		{
 			if (bonus->propagationUpdater && bonus->propagationUpdater == b->propagationUpdater)
 			{
-				treeHasChanged();
+				nodeHasChanged();
 				return true;
 			}
 			return false;
@@ -556,7 +625,7 @@ void CBonusSystemNode::exportBonus(const std::shared_ptr<Bonus> & b)
 	else
 		bonuses.push_back(b);
 
-	CBonusSystemNode::treeHasChanged();
+	nodeHasChanged();
 }
 
 void CBonusSystemNode::exportBonuses()
@@ -630,9 +699,36 @@ void CBonusSystemNode::treeHasChanged()
 	treeChanged++;
 }
 
+void CBonusSystemNode::nodeHasChanged() const
+{
+	invalidateNode(invalidationCounter++);
+}
+
+void CBonusSystemNode::invalidateNode(int64_t invalidationId) const
+{
+	// node may be reachable through multiple paths, visit it only once per invalidation
+	if(nodeChanged == invalidationId)
+		return;
+
+	nodeChanged = invalidationId;
+
+	for(const auto * child : inheritingNodes)
+		child->invalidateNode(invalidationId);
+}
+
 int64_t CBonusSystemNode::getTreeVersion() const
 {
-	return treeChanged;
+	// Both counters only grow, so their sum changes on every change of this node, its ancestors or the whole tree
+	int64_t result = treeChanged + nodeChanged;
+
+	// hypothetic nodes are not registered in their parents and can't be notified of changes
+	if(isHypothetic())
+	{
+		for(const auto * parent : parentsToInherit)
+			result += parent->getTreeVersion();
+	}
+
+	return result;
 }
 
 VCMI_LIB_NAMESPACE_END
@@ -37,16 +37,24 @@ private:
 	TCNodesVector parentsToInherit; // we inherit bonuses from them
 	TNodesVector parentsToPropagate; // we may attach our bonuses to them
 	TNodesVector children;
+	mutable TNodesVector inheritingNodes; // nodes that inherit bonuses from us and need to be invalidated on our changes
 
 	ENodeTypes nodeType;
 	bool isHypotheticNode;
 
 	static const bool cachingEnabled;
 	mutable BonusList cachedBonuses;
+	mutable std::vector<std::shared_ptr<Bonus>> cachedBonusesByType; // same as cachedBonuses, but sorted by bonus type
 	mutable int64_t cachedLast;
+	mutable std::atomic<int64_t> nodeChanged;
 	static std::atomic<int64_t> treeChanged;
+	static std::atomic<int64_t> invalidationCounter;
+
+	// Requests with selectors that consist only of bonus field checks are cached automatically.
+	mutable std::unordered_map<std::pair<CSelector, CSelector>, TBonusListPtr, boost::hash<std::pair<CSelector, CSelector>>> cachedSelectorRequests;
 
 	// Setting a value to cachingStr before getting any bonuses caches the result for later requests.
+	// Only needed for selectors with custom functors that can't be compared.
 	// This string needs to be unique, that's why it has to be set in the following manner:
 	// [property key]_[value] => only for selector
 	mutable std::map<std::string, TBonusListPtr > cachedRequests;
@@ -54,6 +62,7 @@ private:
 
 	void getAllBonusesRec(BonusList &out, const CSelector & selector) const;
 	TConstBonusListPtr getAllBonusesWithoutCaching(const CSelector &selector, const CSelector &limit) const;
+	void getCachedBonuses(BonusList & out, const CSelector & selector, const CSelector & limit) const;
 	std::shared_ptr<Bonus> getUpdatedBonus(const std::shared_ptr<Bonus> & b, const TUpdaterPtr & updater) const;
 	void limitBonuses(const BonusList &allBonuses, BonusList &out) const; //out will bo populed with bonuses that are not limited here
 
@@ -76,6 +85,8 @@ private:
 
 	void exportBonus(const std::shared_ptr<Bonus> & b);
 
+	void invalidateNode(int64_t invalidationId) const;
+
 protected:
 	bool isIndependentNode() const; //node is independent when it has no parents nor children
 	void exportBonuses();
@@ -120,8 +131,12 @@ public:
 	void setNodeType(CBonusSystemNode::ENodeTypes type);
 	const TCNodesVector & getParentNodes() const;
 
+	/// Invalidates cached bonuses of every node in the game, should only be used for changes that are not visible to bonus tree
 	static void treeHasChanged();
 
+	/// Invalidates cached bonuses of this node and all nodes that inherit bonuses from it
+	void nodeHasChanged() const;
+
 	int64_t getTreeVersion() const override;
 
 	virtual PlayerColor getOwner() const
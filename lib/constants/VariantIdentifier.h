@@ -54,6 +54,12 @@ public:
 			return IdentifierType();
 	}
 
+	/// Returns index of identifier type that is currently stored in this variant
+	size_t getTypeIndex() const
+	{
+		return value.index();
+	}
+
 	bool hasValue() const
 	{
 		bool result = false;
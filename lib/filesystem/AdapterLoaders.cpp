@@ -64,12 +64,55 @@ CFilesystemList::~CFilesystemList()
 {
 }
 
+void CFilesystemList::contentChanged() const
+{
+	// lists can be nested, so change in one list invalidates index of all its parents as well
+	for(const CFilesystemList * list = this; list != nullptr; list = list->parentList)
+		list->generation++;
+}
+
+template<typename Func>
+auto CFilesystemList::accessIndex(Func && func) const
+{
+	{
+		boost::shared_lock<boost::shared_mutex> lock(indexMutex);
+		if (indexGeneration == generation)
+			return func(resourceIndex);
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(indexMutex);
+	if (indexGeneration != generation)
+		rebuildIndex();
+	return func(resourceIndex);
+}
+
+void CFilesystemList::rebuildIndex() const
+{
+	uint32_t currentGeneration = generation;
+
+	resourceIndex.clear();
+	for(const auto & loader : loaders)
+	{
+		for(const auto & resource : loader->getFilteredFiles([](const ResourcePath &){ return true; }))
+			boost::range::copy(loader->getResourcesWithName(resource), std::back_inserter(resourceIndex[resource]));
+	}
+
+	indexGeneration = currentGeneration;
+}
+
 std::unique_ptr<CInputStream> CFilesystemList::load(const ResourcePath & resourceName) const
 {
 	// load resource from last loader that have it (last overridden version)
-	for(const auto & loader : boost::adaptors::reverse(loaders))
-		if (loader->existsResource(resourceName))
-			return loader->load(resourceName);
+	const ISimpleResourceLoader * loader = accessIndex([&](const ResourceIndex & index) -> const ISimpleResourceLoader *
+	{
+		auto it = index.find(resourceName);
+		if (it == index.end())
+			return nullptr;
+		return it->second.back();
+	});
+
+	if (loader)
+		return loader->load(resourceName);
 
 	throw std::runtime_error("Resource with name " + resourceName.getName() + " and type "
 		+ EResTypeHelper::getEResTypeAsString(resourceName.getType()) + " wasn't found.");
@@ -77,10 +120,10 @@ std::unique_ptr<CInputStream> CFilesystemList::load(const ResourcePath & resourc
 
 bool CFilesystemList::existsResource(const ResourcePath & resourceName) const
 {
-	for(const auto & loader : loaders)
-		if (loader->existsResource(resourceName))
-			return true;
-	return false;
+	return accessIndex([&](const ResourceIndex & index)
+	{
+		return index.count(resourceName) != 0;
+	});
 }
 
 std::string CFilesystemList::getMountPoint() const
@@ -113,6 +156,7 @@ void CFilesystemList::updateFilteredFiles(std::function<bool(const std::string &
 {
 	for(const auto & loader : loaders)
 		loader->updateFilteredFiles(filter);
+	contentChanged();
 }
 
 std::unordered_set<ResourcePath> CFilesystemList::getFilteredFiles(std::function<bool(const ResourcePath &)> filter) const
@@ -131,9 +175,17 @@ bool CFilesystemList::createResource(const std::string & filename, bool update)
 	logGlobal->trace("Creating %s", filename);
 	for (auto & loader : boost::adaptors::reverse(loaders))
 	{
-		if (writeableLoaders.count(loader.get()) != 0                       // writeable,
-			&& loader->createResource(filename, update))          // successfully created
+		if (writeableLoaders.count(loader.get()) == 0)
+			continue;
+
+		// creating already existing file (e.g. overwriting save) does not change list of files
+		bool existedBefore = loader->existsResource(ResourcePath(filename));
+
+		if (loader->createResource(filename, update))
 		{
+			if (!existedBefore)
+				contentChanged();
+
 			// Check if resource was created successfully. Possible reasons for this to fail
 			// a) loader failed to create resource (e.g. read-only FS)
 			// b) in update mode, call with filename that does not exists
@@ -149,19 +201,23 @@ bool CFilesystemList::createResource(const std::string & filename, bool update)
 
 std::vector<const ISimpleResourceLoader *> CFilesystemList::getResourcesWithName(const ResourcePath & resourceName) const
 {
-	std::vector<const ISimpleResourceLoader *> ret;
-
-	for(const auto & loader : loaders)
-		boost::range::copy(loader->getResourcesWithName(resourceName), std::back_inserter(ret));
-
-	return ret;
+	return accessIndex([&](const ResourceIndex & index)
+	{
+		auto it = index.find(resourceName);
+		if (it == index.end())
+			return std::vector<const ISimpleResourceLoader *>();
+		return it->second;
+	});
 }
 
 void CFilesystemList::addLoader(ISimpleResourceLoader * loader, bool writeable)
 {
 	loaders.push_back(std::unique_ptr<ISimpleResourceLoader>(loader));
+	if (auto * list = dynamic_cast<CFilesystemList *>(loader))
+		list->parentList = this;
 	if (writeable)
 		writeableLoaders.insert(loader);
+	contentChanged();
 }
 
 bool CFilesystemList::removeLoader(ISimpleResourceLoader * loader)
@@ -172,6 +228,7 @@ bool CFilesystemList::removeLoader(ISimpleResourceLoader * loader)
 		{
 			loaders.erase(loaderIterator);
 			writeableLoaders.erase(loader);
+			contentChanged();
 			return true;
 		}
 	}
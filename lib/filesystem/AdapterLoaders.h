@@ -59,6 +59,29 @@ class DLL_LINKAGE CFilesystemList : public ISimpleResourceLoader
 
 	std::set<ISimpleResourceLoader *> writeableLoaders;
 
+	/// Merged index of all resources of all loaders in this list
+	/// key = resource, value = all leaf loaders that contain it, in mount order
+	using ResourceIndex = std::unordered_map<ResourcePath, std::vector<const ISimpleResourceLoader *>>;
+
+	mutable ResourceIndex resourceIndex;
+	mutable boost::shared_mutex indexMutex;
+	/// Incremented on every change of this list, its loaders or nested lists
+	mutable std::atomic<uint32_t> generation{1};
+	/// Value of generation at the moment of index creation
+	mutable uint32_t indexGeneration = 0;
+	/// List that contains this list as one of its loaders, if any
+	CFilesystemList * parentList = nullptr;
+
+	/// Rebuilds index, must be called with exclusive lock on indexMutex
+	void rebuildIndex() const;
+
+	/// Invalidates index of this list and of all lists that contain it
+	void contentChanged() const;
+
+	/// Calls provided functor with up-to-date index, rebuilding it if any filesystem was modified since last call
+	template<typename Func>
+	auto accessIndex(Func && func) const;
+
 	//FIXME: this is only compile fix, should be removed in the end
 	CFilesystemList(CFilesystemList &) = delete;
 	CFilesystemList &operator=(CFilesystemList &) = delete;
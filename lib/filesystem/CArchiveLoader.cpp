@@ -13,11 +13,128 @@
 #include "VCMIDirs.h"
 #include "CFileInputStream.h"
 #include "CCompressedStream.h"
+#include "CMemoryStream.h"
 
 #include "CBinaryReader.h"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <zlib.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Stream over uncompressed archive entry that reads directly from mapped archive
+class CMappedArchiveStream final : public CMemoryStream
+{
+	/// Keeps archive mapped while stream exists
+	std::shared_ptr<const boost::interprocess::mapped_region> mapping;
+
+public:
+	CMappedArchiveStream(std::shared_ptr<const boost::interprocess::mapped_region> mapping, si64 offset, si64 size)
+		: CMemoryStream(static_cast<const ui8 *>(mapping->get_address()) + offset, size)
+		, mapping(std::move(mapping))
+	{
+	}
+};
+
+/// Stream over deflate-compressed archive entry that takes input directly from mapped archive
+/// If whole entry is read at once, data is decompressed directly into caller-provided buffer
+/// Otherwise, entry is decompressed into internal buffer on first access
+class CMappedCompressedStream final : public CInputStream
+{
+	std::shared_ptr<const boost::interprocess::mapped_region> mapping;
+	const ui8 * compressedData;
+	si64 compressedSize;
+	si64 fullSize;
+	si64 position;
+
+	std::vector<ui8> decompressedData;
+	bool decompressed;
+
+	si64 decompressInto(ui8 * output) const
+	{
+		z_stream inflateState = {};
+
+		if (inflateInit(&inflateState) != Z_OK)
+			throw DecompressionException("Failed to initialize inflate!");
+
+		inflateState.next_in = const_cast<ui8 *>(compressedData);
+		inflateState.avail_in = static_cast<uInt>(compressedSize);
+		inflateState.next_out = output;
+		inflateState.avail_out = static_cast<uInt>(fullSize);
+
+		int ret = inflate(&inflateState, Z_FINISH);
+		si64 result = inflateState.total_out;
+		inflateEnd(&inflateState);
+
+		if (ret != Z_STREAM_END && ret != Z_BUF_ERROR)
+			throw DecompressionException("Error code " + std::to_string(ret));
+
+		return result;
+	}
+
+	void ensureDecompressed()
+	{
+		if (decompressed)
+			return;
+
+		decompressedData.resize(fullSize);
+		decompressedData.resize(decompressInto(decompressedData.data()));
+		fullSize = decompressedData.size();
+		decompressed = true;
+	}
+
+public:
+	CMappedCompressedStream(std::shared_ptr<const boost::interprocess::mapped_region> mapping, si64 offset, si64 compressedSize, si64 fullSize)
+		: mapping(std::move(mapping))
+		, compressedData(static_cast<const ui8 *>(this->mapping->get_address()) + offset)
+		, compressedSize(compressedSize)
+		, fullSize(fullSize)
+		, position(0)
+		, decompressed(false)
+	{
+	}
+
+	si64 read(ui8 * data, si64 size) override
+	{
+		if (!decompressed && position == 0 && size >= fullSize)
+		{
+			// entry may contain less data than archive header claims
+			position = decompressInto(data);
+			fullSize = position;
+			return position;
+		}
+
+		ensureDecompressed();
+		si64 toRead = std::clamp<si64>(fullSize - position, 0, size);
+		std::copy_n(decompressedData.data() + position, toRead, data);
+		position += toRead;
+		return toRead;
+	}
+
+	si64 seek(si64 newPosition) override
+	{
+		position = std::clamp<si64>(newPosition, 0, fullSize);
+		return position;
+	}
+
+	si64 tell() override
+	{
+		return position;
+	}
+
+	si64 skip(si64 delta) override
+	{
+		si64 origin = position;
+		return seek(position + delta) - origin;
+	}
+
+	si64 getSize() override
+	{
+		return fullSize;
+	}
+};
+
 ArchiveEntry::ArchiveEntry()
 	: offset(0), fullSize(0), compressedSize(0)
 {
@@ -50,6 +167,26 @@ CArchiveLoader::CArchiveLoader(std::string _mountPoint, boost::filesystem::path
 		throw std::runtime_error("LOD archive format unknown. Cannot deal with " + archive.string());
 
 	logGlobal->trace("%sArchive \"%s\" loaded (%d files found).", ext, archive.filename(), entries.size());
+
+	mapArchive();
+}
+
+void CArchiveLoader::mapArchive()
+{
+	// H3 archives may take up to ~1 Gb, which is too much for address space of 32-bit systems
+	if (sizeof(void *) < 8)
+		return;
+
+	try
+	{
+		boost::interprocess::file_mapping file(archive.string().c_str(), boost::interprocess::read_only);
+		mappedArchive = std::make_shared<const boost::interprocess::mapped_region>(file, boost::interprocess::read_only);
+	}
+	catch (const boost::interprocess::interprocess_exception & e)
+	{
+		logGlobal->debug("Failed to map archive %s into memory: %s", archive.string(), e.what());
+		mappedArchive.reset();
+	}
 }
 
 void CArchiveLoader::initLODArchive(const std::string &mountPoint, CFileInputStream & fileStream)
@@ -175,6 +312,19 @@ std::unique_ptr<CInputStream> CArchiveLoader::load(const ResourcePath & resource
 
 	const ArchiveEntry & entry = entries.at(resourceName);
 
+	if (mappedArchive)
+	{
+		si64 storedSize = entry.compressedSize != 0 ? entry.compressedSize : entry.fullSize;
+
+		if (entry.offset < 0 || entry.offset + storedSize > static_cast<si64>(mappedArchive->get_size()))
+			throw std::runtime_error("Entry " + entry.name + " is located outside of archive " + archive.string());
+
+		if (entry.compressedSize != 0)
+			return std::make_unique<CMappedCompressedStream>(mappedArchive, entry.offset, entry.compressedSize, entry.fullSize);
+		else
+			return std::make_unique<CMappedArchiveStream>(mappedArchive, entry.offset, entry.fullSize);
+	}
+
 	if (entry.compressedSize != 0) //compressed data
 	{
 		auto fileStream = std::make_unique<CFileInputStream>(archive, entry.offset, entry.compressedSize);
@@ -12,6 +12,14 @@
 #include "ISimpleResourceLoader.h"
 #include "ResourcePath.h"
 
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 class CFileInputStream;
@@ -93,6 +101,12 @@ private:
 	 */
 	void initSNDArchive(const std::string &mountPoint, CFileInputStream & fileStream);
 
+	/**
+	 * Maps whole archive into memory, if possible.
+	 * On failure archive entries will be read using regular file streams
+	 */
+	void mapArchive();
+
 	/** The file path to the archive which is scanned and indexed. */
 	boost::filesystem::path archive;
 
@@ -103,6 +117,9 @@ private:
 
 	/** Specifies if Original H3 archives should be extracted to a separate folder **/
 	bool extractArchives;
+
+	/** Memory mapping of the whole archive or nullptr if archive is not mapped. Shared with all streams created by this loader **/
+	std::shared_ptr<const boost::interprocess::mapped_region> mappedArchive;
 };
 
 /** Constructs the file path for the extracted file. Creates the subfolder hierarchy aswell **/
@@ -0,0 +1,346 @@
+/*
+ * CompactJsonTree.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "CompactJsonTree.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class CompactJsonTree::Builder
+{
+	CompactJsonTree & tree;
+	std::unordered_map<std::string, uint32_t> keyIndices;
+	std::unordered_map<std::string, uint16_t> scopeIndices;
+
+	uint32_t internKey(const std::string & key)
+	{
+		auto it = keyIndices.find(key);
+		if(it != keyIndices.end())
+			return it->second;
+
+		uint32_t index = tree.keys.size();
+		tree.keys.push_back(key);
+		keyIndices[key] = index;
+		return index;
+	}
+
+	uint16_t internScope(const std::string & scope)
+	{
+		auto it = scopeIndices.find(scope);
+		if(it != scopeIndices.end())
+			return it->second;
+
+		if(tree.scopes.size() > std::numeric_limits<uint16_t>::max())
+			throw std::runtime_error("Too many mod scopes in json tree!");
+
+		uint16_t index = tree.scopes.size();
+		tree.scopes.push_back(scope);
+		scopeIndices[scope] = index;
+		return index;
+	}
+
+	/// Reserves space for children of node right after each other, so they can be found using index of first child
+	uint32_t allocateChildren(size_t count)
+	{
+		if(tree.nodes.size() + count > std::numeric_limits<uint32_t>::max())
+			throw std::runtime_error("Json tree is too large!");
+
+		uint32_t first = tree.nodes.size();
+		tree.nodes.resize(tree.nodes.size() + count);
+		return first;
+	}
+
+public:
+	explicit Builder(CompactJsonTree & tree)
+		: tree(tree)
+	{
+		internScope("");
+	}
+
+	static size_t countNodes(const JsonNode & source)
+	{
+		size_t result = 1;
+		if(source.isVector())
+		{
+			for(const auto & child : source.Vector())
+				result += countNodes(child);
+		}
+		if(source.isStruct())
+		{
+			for(const auto & child : source.Struct())
+				result += countNodes(child.second);
+		}
+		return result;
+	}
+
+	void fill(uint32_t index, const JsonNode & source)
+	{
+		// nodes may be reallocated when children are added, so node is accessed only via index
+		tree.nodes[index].type = static_cast<uint8_t>(source.getType());
+		tree.nodes[index].overrideFlag = source.getOverrideFlag();
+		tree.nodes[index].scope = internScope(source.getModScope());
+
+		switch(source.getType())
+		{
+			case JsonNode::JsonType::DATA_BOOL:
+				tree.nodes[index].value = source.Bool();
+				break;
+			case JsonNode::JsonType::DATA_FLOAT:
+			{
+				double number = source.Float();
+				static_assert(sizeof(number) == sizeof(tree.nodes[index].value));
+				std::memcpy(&tree.nodes[index].value, &number, sizeof(number));
+				break;
+			}
+			case JsonNode::JsonType::DATA_INTEGER:
+				tree.nodes[index].value = source.Integer();
+				break;
+			case JsonNode::JsonType::DATA_STRING:
+			{
+				const std::string & string = source.String();
+				if(tree.characters.size() + string.size() > std::numeric_limits<uint32_t>::max())
+					throw std::runtime_error("Json tree is too large!");
+
+				tree.nodes[index].first = tree.characters.size();
+				tree.nodes[index].size = string.size();
+				tree.characters += string;
+				break;
+			}
+			case JsonNode::JsonType::DATA_VECTOR:
+			{
+				const JsonVector & vector = source.Vector();
+				uint32_t first = allocateChildren(vector.size());
+				tree.nodes[index].first = first;
+				tree.nodes[index].size = vector.size();
+
+				for(size_t i = 0; i < vector.size(); ++i)
+					fill(first + i, vector[i]);
+				break;
+			}
+			case JsonNode::JsonType::DATA_STRUCT:
+			{
+				// JsonMap is ordered by key, so entries are already sorted
+				const JsonMap & map = source.Struct();
+				uint32_t first = allocateChildren(map.size());
+				tree.nodes[index].first = first;
+				tree.nodes[index].size = map.size();
+
+				uint32_t child = first;
+				for(const auto & entry : map)
+				{
+					tree.nodes[child].key = internKey(entry.first);
+					fill(child, entry.second);
+					++child;
+				}
+				break;
+			}
+			default:
+				break;
+		}
+	}
+};
+
+CompactJsonTree::CompactJsonTree()
+	: nodes(1)
+	, scopes({""})
+{
+}
+
+CompactJsonTree::CompactJsonTree(const JsonNode & source)
+{
+	Builder builder(*this);
+	nodes.reserve(Builder::countNodes(source));
+	nodes.resize(1);
+	builder.fill(0, source);
+	keys.shrink_to_fit();
+	scopes.shrink_to_fit();
+}
+
+CompactJsonView CompactJsonTree::root() const
+{
+	return CompactJsonView(this, 0);
+}
+
+size_t CompactJsonTree::memoryUsage() const
+{
+	size_t result = nodes.capacity() * sizeof(Node) + characters.capacity();
+	for(const auto & key : keys)
+		result += sizeof(key) + key.capacity();
+	for(const auto & scope : scopes)
+		result += sizeof(scope) + scope.capacity();
+	return result;
+}
+
+CompactJsonView::CompactJsonView(const CompactJsonTree * tree, uint32_t index)
+	: tree(tree)
+	, index(index)
+{
+}
+
+JsonNode::JsonType CompactJsonView::getType() const
+{
+	if(!tree)
+		return JsonNode::JsonType::DATA_NULL;
+	return static_cast<JsonNode::JsonType>(tree->nodes[index].type);
+}
+
+bool CompactJsonView::isNull() const
+{
+	return getType() == JsonNode::JsonType::DATA_NULL;
+}
+
+bool CompactJsonView::isStruct() const
+{
+	return getType() == JsonNode::JsonType::DATA_STRUCT;
+}
+
+bool CompactJsonView::isVector() const
+{
+	return getType() == JsonNode::JsonType::DATA_VECTOR;
+}
+
+const std::string & CompactJsonView::getModScope() const
+{
+	static const std::string emptyScope;
+
+	if(!tree)
+		return emptyScope;
+	return tree->scopes[tree->nodes[index].scope];
+}
+
+bool CompactJsonView::getOverrideFlag() const
+{
+	return tree && tree->nodes[index].overrideFlag;
+}
+
+bool CompactJsonView::Bool() const
+{
+	assert(getType() == JsonNode::JsonType::DATA_BOOL);
+	return tree->nodes[index].value != 0;
+}
+
+double CompactJsonView::Float() const
+{
+	if(getType() == JsonNode::JsonType::DATA_INTEGER)
+		return static_cast<double>(tree->nodes[index].value);
+
+	assert(getType() == JsonNode::JsonType::DATA_FLOAT);
+	double result;
+	std::memcpy(&result, &tree->nodes[index].value, sizeof(result));
+	return result;
+}
+
+si64 CompactJsonView::Integer() const
+{
+	if(getType() == JsonNode::JsonType::DATA_FLOAT)
+		return static_cast<si64>(Float());
+
+	assert(getType() == JsonNode::JsonType::DATA_INTEGER);
+	return tree->nodes[index].value;
+}
+
+std::string_view CompactJsonView::String() const
+{
+	assert(getType() == JsonNode::JsonType::DATA_STRING);
+	const auto & node = tree->nodes[index];
+	return std::string_view(tree->characters.data() + node.first, node.size);
+}
+
+size_t CompactJsonView::size() const
+{
+	if(!isVector() && !isStruct())
+		return 0;
+	return tree->nodes[index].size;
+}
+
+CompactJsonView CompactJsonView::operator[](size_t child) const
+{
+	assert(isVector());
+	assert(child < size());
+	return CompactJsonView(tree, tree->nodes[index].first + child);
+}
+
+CompactJsonView CompactJsonView::operator[](std::string_view child) const
+{
+	if(!isStruct())
+		return CompactJsonView();
+
+	const auto & node = tree->nodes[index];
+	auto begin = tree->nodes.begin() + node.first;
+	auto end = begin + node.size;
+
+	auto it = std::lower_bound(begin, end, child, [this](const CompactJsonTree::Node & entry, std::string_view key)
+	{
+		return tree->keys[entry.key] < key;
+	});
+
+	if(it == end || tree->keys[it->key] != child)
+		return CompactJsonView();
+
+	return CompactJsonView(tree, it - tree->nodes.begin());
+}
+
+const std::string & CompactJsonView::keyAt(size_t position) const
+{
+	assert(isStruct());
+	assert(position < size());
+	return tree->keys[tree->nodes[tree->nodes[index].first + position].key];
+}
+
+CompactJsonView CompactJsonView::valueAt(size_t position) const
+{
+	assert(isStruct());
+	assert(position < size());
+	return CompactJsonView(tree, tree->nodes[index].first + position);
+}
+
+JsonNode CompactJsonView::toJsonNode() const
+{
+	JsonNode result;
+
+	switch(getType())
+	{
+		case JsonNode::JsonType::DATA_BOOL:
+			result = JsonNode(Bool());
+			break;
+		case JsonNode::JsonType::DATA_FLOAT:
+			result = JsonNode(Float());
+			break;
+		case JsonNode::JsonType::DATA_INTEGER:
+			result = JsonNode(static_cast<int64_t>(Integer()));
+			break;
+		case JsonNode::JsonType::DATA_STRING:
+			result = JsonNode(std::string(String()));
+			break;
+		case JsonNode::JsonType::DATA_VECTOR:
+		{
+			JsonVector & vector = result.Vector();
+			vector.reserve(size());
+			for(size_t i = 0; i < size(); ++i)
+				vector.push_back((*this)[i].toJsonNode());
+			break;
+		}
+		case JsonNode::JsonType::DATA_STRUCT:
+		{
+			JsonMap & map = result.Struct();
+			for(size_t i = 0; i < size(); ++i)
+				map.emplace_hint(map.end(), keyAt(i), valueAt(i).toJsonNode());
+			break;
+		}
+		default:
+			break;
+	}
+
+	result.setModScope(getModScope(), false);
+	result.setOverrideFlag(getOverrideFlag());
+	return result;
+}
+
+VCMI_LIB_NAMESPACE_END
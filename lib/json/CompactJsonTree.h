@@ -0,0 +1,120 @@
+/*
+ * CompactJsonTree.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "JsonNode.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+class CompactJsonTree;
+
+/// Read-only reference to node of CompactJsonTree. Valid as long as tree it points to is alive and unchanged
+class DLL_LINKAGE CompactJsonView
+{
+	friend class CompactJsonTree;
+
+	const CompactJsonTree * tree = nullptr;
+	uint32_t index = 0;
+
+	CompactJsonView(const CompactJsonTree * tree, uint32_t index);
+
+public:
+	/// Null node that is not part of any tree
+	CompactJsonView() = default;
+
+	JsonNode::JsonType getType() const;
+	bool isNull() const;
+	bool isStruct() const;
+	bool isVector() const;
+
+	const std::string & getModScope() const;
+	bool getOverrideFlag() const;
+
+	bool Bool() const;
+	/// float and integer allowed
+	double Float() const;
+	si64 Integer() const;
+	std::string_view String() const;
+
+	/// number of elements of vector or entries of struct, 0 for other types
+	size_t size() const;
+
+	/// element of vector
+	CompactJsonView operator[](size_t child) const;
+	/// entry of struct, null node if there is no such entry
+	CompactJsonView operator[](std::string_view child) const;
+
+	/// name and value of struct entry by its position, entries are sorted by name
+	const std::string & keyAt(size_t position) const;
+	CompactJsonView valueAt(size_t position) const;
+
+	/// creates mutable copy of this node and all its children
+	JsonNode toJsonNode() const;
+};
+
+/// Immutable copy of json tree for data that is kept for long time but rarely accessed
+/// All nodes are stored in one flat array, all string values in one character buffer,
+/// struct keys are interned and struct entries are stored as sorted arrays of nodes
+/// Use JsonNode for data that needs to be modified
+class DLL_LINKAGE CompactJsonTree
+{
+	friend class CompactJsonView;
+
+	struct Node
+	{
+		uint8_t type = 0; // JsonNode::JsonType
+		bool overrideFlag = false;
+		uint16_t scope = 0; // index in scopes
+		uint32_t key = 0; // index in keys, only for entries of struct
+		uint32_t size = 0; // number of children or length of string
+		uint32_t first = 0; // index of first child or offset of string in characters
+		int64_t value = 0; // boolean, integer or bit representation of floating point number
+
+		template<typename Handler>
+		void serialize(Handler & h)
+		{
+			h & type;
+			h & overrideFlag;
+			h & scope;
+			h & key;
+			h & size;
+			h & first;
+			h & value;
+		}
+	};
+
+	std::vector<Node> nodes; // root is first node, children of every node are stored next to each other
+	std::string characters;
+	std::vector<std::string> keys;
+	std::vector<std::string> scopes;
+
+	class Builder;
+
+public:
+	/// Creates tree with single null node
+	CompactJsonTree();
+	explicit CompactJsonTree(const JsonNode & source);
+
+	CompactJsonView root() const;
+
+	/// Approximate size of memory used by tree
+	size_t memoryUsage() const;
+
+	template<typename Handler>
+	void serialize(Handler & h)
+	{
+		h & nodes;
+		h & characters;
+		h & keys;
+		h & scopes;
+	}
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -142,9 +142,36 @@ JsonNode::JsonType JsonNode::getType() const
 	return static_cast<JsonType>(data.index());
 }
 
+/// Mod scope is set on every node of every config, but there is only a few hundreds of different scopes
+/// Store each of them only once and keep only pointer to it in nodes
+static const std::string * internModScope(const std::string & scope)
+{
+	static std::mutex internedScopesMutex;
+	static std::unordered_set<std::string> internedScopes;
+
+	// nodes are usually processed in trees that share same scope, so only changes of scope need lookup
+	thread_local std::string lastScope;
+	thread_local const std::string * lastInternedScope = nullptr;
+
+	if(scope.empty())
+		return nullptr;
+
+	if(lastInternedScope && scope == lastScope)
+		return lastInternedScope;
+
+	std::lock_guard lock(internedScopesMutex);
+	lastScope = scope;
+	lastInternedScope = &*internedScopes.insert(scope).first;
+	return lastInternedScope;
+}
+
 const std::string & JsonNode::getModScope() const
 {
-	return modScope;
+	static const std::string emptyScope;
+
+	if(modScope == nullptr)
+		return emptyScope;
+	return *modScope;
 }
 
 void JsonNode::setOverrideFlag(bool value)
@@ -159,28 +186,34 @@ bool JsonNode::getOverrideFlag() const
 
 void JsonNode::setModScope(const std::string & metadata, bool recursive)
 {
-	modScope = metadata;
+	const std::string * scope = internModScope(metadata);
+
 	if(recursive)
+		assignModScope(scope);
+	else
+		modScope = scope;
+}
+
+void JsonNode::assignModScope(const std::string * scope)
+{
+	modScope = scope;
+
+	switch(getType())
 	{
-		switch(getType())
+		case JsonType::DATA_VECTOR:
 		{
-			break;
-			case JsonType::DATA_VECTOR:
-			{
-				for(auto & node : Vector())
-				{
-					node.setModScope(metadata);
-				}
-			}
-			break;
-			case JsonType::DATA_STRUCT:
-			{
-				for(auto & node : Struct())
-				{
-					node.second.setModScope(metadata);
-				}
-			}
+			for(auto & node : Vector())
+				node.assignModScope(scope);
+		}
+		break;
+		case JsonType::DATA_STRUCT:
+		{
+			for(auto & node : Struct())
+				node.second.assignModScope(scope);
 		}
+		break;
+		default:
+			break;
 	}
 }
 
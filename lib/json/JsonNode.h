@@ -55,10 +55,14 @@ private:
 	JsonData data;
 
 	/// Mod-origin of this particular field
-	std::string modScope;
+	/// Points to interned string shared by all nodes with same scope, or nullptr if scope is empty
+	const std::string * modScope = nullptr;
 
 	bool overrideFlag = false;
 
+	/// Recursively assigns already interned mod scope
+	void assignModScope(const std::string * scope);
+
 public:
 	JsonNode() = default;
 
@@ -151,7 +155,16 @@ public:
 	template<typename Handler>
 	void serialize(Handler & h)
 	{
-		h & modScope;
+		if constexpr (Handler::saving)
+		{
+			h & getModScope();
+		}
+		else
+		{
+			std::string scope;
+			h & scope;
+			setModScope(scope, false);
+		}
 		h & overrideFlag;
 		h & data;
 	}
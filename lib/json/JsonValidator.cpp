@@ -237,7 +237,7 @@ static std::string refCheck(JsonValidator & validator, const JsonNode & baseSche
 
 static std::string formatCheck(JsonValidator & validator, const JsonNode & baseSchema, const JsonNode & schema, const JsonNode & data)
 {
-	auto formats = validator.getKnownFormats();
+	const auto & formats = JsonValidator::getKnownFormats();
 	std::string errors;
 	auto checker = formats.find(schema.String());
 	if (checker != formats.end())
@@ -700,6 +700,163 @@ std::string JsonValidator::makeErrorMessage(const std::string &message)
 	return errors;
 }
 
+/// Check of a single schema keyword with all schema lookups already performed
+using TCompiledCheck = std::function<std::string(JsonValidator &, const JsonNode &)>;
+
+/// Schema node in which every keyword is resolved into its check for every possible type of validated data
+struct CompiledSchema
+{
+	/// Checks for each type of data, in same order as keywords are listed in schema
+	std::array<std::vector<TCompiledCheck>, 7> checks;
+};
+
+/// All compiled schema nodes. Named schemas are never unloaded, so their nodes can be used as keys
+static std::unordered_map<const JsonNode *, CompiledSchema> compiledSchemas;
+static boost::shared_mutex compiledSchemasMutex;
+
+static void compileSchemaNode(const std::string & schemaName, const JsonNode & schema);
+
+static std::string resolveSchemaReference(const std::string & schemaName, const std::string & reference)
+{
+	//Local reference. Turn it into more easy to handle remote ref
+	if (boost::algorithm::starts_with(reference, "#"))
+		return schemaName.substr(0, schemaName.find('#')) + reference;
+	return reference;
+}
+
+static TCompiledCheck compileReference(const std::string & schemaName, const JsonNode & reference)
+{
+	std::string URI = resolveSchemaReference(schemaName, reference.String());
+	const JsonNode & target = JsonUtils::getSchema(URI);
+
+	compileSchemaNode(URI, target);
+
+	return [URI, &target](JsonValidator & validator, const JsonNode & data)
+	{
+		//node must be validated using schema pointed by this reference and not by data here
+		validator.usedSchemas.push_back(URI);
+		auto onscopeExit = vstd::makeScopeGuard([&validator]()
+		{
+			validator.usedSchemas.pop_back();
+		});
+		return validator.check(target, data);
+	};
+}
+
+static TCompiledCheck compileEnum(const JsonNode & schema, const JsonNode & enumList, const JsonValidator::TFieldValidator & genericCheck)
+{
+	std::unordered_set<std::string> allowedStrings;
+
+	for(const auto & enumEntry : enumList.Vector())
+	{
+		if (!enumEntry.isString())
+		{
+			// enum with non-string values, fallback to generic comparison
+			return [&genericCheck, &schema, &enumList](JsonValidator & validator, const JsonNode & data)
+			{
+				return genericCheck(validator, schema, enumList, data);
+			};
+		}
+		allowedStrings.insert(enumEntry.String());
+	}
+
+	return [allowedStrings, &genericCheck, &schema, &enumList](JsonValidator & validator, const JsonNode & data)
+	{
+		if (data.isString() && allowedStrings.count(data.String()))
+			return std::string();
+		return genericCheck(validator, schema, enumList, data);
+	};
+}
+
+/// Compiles schema and all schemas that may be used for validation of its subnodes. Must be called with exclusive lock
+static void compileSchemaNode(const std::string & schemaName, const JsonNode & schema)
+{
+	if (!schema.isStruct() || compiledSchemas.count(&schema))
+		return;
+
+	// insert entry first to handle recursive schemas
+	CompiledSchema & compiled = compiledSchemas[&schema];
+
+	const auto & compileSubschema = [&schemaName](const JsonNode & node)
+	{
+		if (node.isVector())
+		{
+			for(const auto & entry : node.Vector())
+				compileSchemaNode(schemaName, entry);
+		}
+		else
+			compileSchemaNode(schemaName, node);
+	};
+
+	const auto & compileSubschemaMap = [&schemaName](const JsonNode & node)
+	{
+		if (node.isStruct())
+		{
+			for(const auto & entry : node.Struct())
+				compileSchemaNode(schemaName, entry.second);
+		}
+	};
+
+	TCompiledCheck referenceCheck;
+	if (schema["$ref"].isString())
+		referenceCheck = compileReference(schemaName, schema["$ref"]);
+
+	for(const auto & keyword : { "items", "additionalItems", "additionalProperties", "allOf", "anyOf", "oneOf", "not" })
+		compileSubschema(schema[keyword]);
+
+	for(const auto & keyword : { "properties", "dependencies", "definitions" })
+		compileSubschemaMap(schema[keyword]);
+
+	static constexpr std::array<JsonNode::JsonType, 7> dataTypes = {
+		JsonNode::JsonType::DATA_NULL,
+		JsonNode::JsonType::DATA_BOOL,
+		JsonNode::JsonType::DATA_FLOAT,
+		JsonNode::JsonType::DATA_STRING,
+		JsonNode::JsonType::DATA_VECTOR,
+		JsonNode::JsonType::DATA_STRUCT,
+		JsonNode::JsonType::DATA_INTEGER
+	};
+
+	for(const auto & dataType : dataTypes)
+	{
+		const auto & knownFields = JsonValidator::getKnownFieldsFor(dataType);
+		auto & checks = compiled.checks[static_cast<size_t>(dataType)];
+
+		for(const auto & entry : schema.Struct())
+		{
+			auto checker = knownFields.find(entry.first);
+			if (checker == knownFields.end())
+				continue;
+
+			if (entry.first == "$ref" && referenceCheck)
+				checks.push_back(referenceCheck);
+			else if (entry.first == "enum" && entry.second.isVector())
+				checks.push_back(compileEnum(schema, entry.second, checker->second));
+			else
+			{
+				const auto & genericCheck = checker->second;
+				const JsonNode & value = entry.second;
+				checks.push_back([&genericCheck, &schema, &value](JsonValidator & validator, const JsonNode & data)
+				{
+					return genericCheck(validator, schema, value, data);
+				});
+			}
+		}
+	}
+}
+
+static void compileSchema(const std::string & schemaName, const JsonNode & schema)
+{
+	{
+		boost::shared_lock<boost::shared_mutex> lock(compiledSchemasMutex);
+		if (compiledSchemas.count(&schema))
+			return;
+	}
+
+	boost::unique_lock<boost::shared_mutex> lock(compiledSchemasMutex);
+	compileSchemaNode(schemaName, schema);
+}
+
 std::string JsonValidator::check(const std::string & schemaName, const JsonNode & data)
 {
 	usedSchemas.push_back(schemaName);
@@ -707,13 +864,33 @@ std::string JsonValidator::check(const std::string & schemaName, const JsonNode
 	{
 		usedSchemas.pop_back();
 	});
-	return check(JsonUtils::getSchema(schemaName), data);
+
+	const JsonNode & schema = JsonUtils::getSchema(schemaName);
+	compileSchema(schemaName, schema);
+	return check(schema, data);
 }
 
 std::string JsonValidator::check(const JsonNode & schema, const JsonNode & data)
 {
-	const TValidatorMap & knownFields = getKnownFieldsFor(data.getType());
+	const CompiledSchema * compiled = nullptr;
+	{
+		boost::shared_lock<boost::shared_mutex> lock(compiledSchemasMutex);
+		auto it = compiledSchemas.find(&schema);
+		if (it != compiledSchemas.end())
+			compiled = &it->second;
+	}
+
 	std::string errors;
+
+	if (compiled)
+	{
+		for(const auto & checker : compiled->checks[static_cast<size_t>(data.getType())])
+			errors += checker(*this, data);
+		return errors;
+	}
+
+	// schema that is not part of any named schema, e.g. created in code
+	const TValidatorMap & knownFields = getKnownFieldsFor(data.getType());
 	for(const auto & entry : schema.Struct())
 	{
 		auto checker = knownFields.find(entry.first);
@@ -33,10 +33,13 @@ struct JsonValidator
 	using TValidatorMap = std::unordered_map<std::string, TFieldValidator>;
 
 	/// map of known fields in schema
-	const TValidatorMap & getKnownFieldsFor(JsonNode::JsonType type);
-	const TFormatMap & getKnownFormats();
+	static const TValidatorMap & getKnownFieldsFor(JsonNode::JsonType type);
+	static const TFormatMap & getKnownFormats();
 
+	/// validates data against schema with specified name
+	/// schema, as well as all its subschemas and references, is compiled on first use
 	std::string check(const std::string & schemaName, const JsonNode & data);
+	/// validates data against schema. Uses compiled form of schema, if it is part of already compiled named schema
 	std::string check(const JsonNode & schema, const JsonNode & data);
 };
 
@@ -748,6 +748,11 @@ void CMap::unbanHero(const HeroTypeID & id)
 	allowedHeroes.insert(id);
 }
 
+void CMap::storeTerrain(TerrainChunkCache & cache) const
+{
+	cache.store(terrain);
+}
+
 void CMap::initTerrain()
 {
 	terrain.resize(boost::extents[levels()][width][height]);
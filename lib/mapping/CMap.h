@@ -12,6 +12,7 @@
 
 #include "CMapDefines.h"
 #include "CMapHeader.h"
+#include "TerrainChunkCache.h"
 
 #include "../ConstTransitivePtr.h"
 #include "../GameCallbackHolder.h"
@@ -187,12 +188,85 @@ public:
 	void overrideGameSetting(EGameSettings option, const JsonNode & input);
 	const IGameSettings & getSettings() const;
 
+	/// Stores static part of map terrain, so it does not have to be received again for next game on this map
+	void storeTerrain(TerrainChunkCache & cache) const;
+
 private:
 	/// a 3-dimensional array of terrain tiles, access is as follows: x, y, level. where level=1 is underground
 	boost::multi_array<TerrainTile, 3> terrain;
 
 	si32 uidCounter; //TODO: initialize when loading an old map
 
+	template <typename Handler>
+	void serializeTerrain(Handler &h)
+	{
+		uint32_t levels = terrain.shape()[0];
+		uint32_t sizeX = terrain.shape()[1];
+		uint32_t sizeY = terrain.shape()[2];
+		h & levels;
+		h & sizeX;
+		h & sizeY;
+
+		if (!h.saving)
+			terrain.resize(boost::extents[levels][sizeX][sizeY]);
+
+		const int chunksX = vstd::divideAndCeil(sizeX, TerrainChunkCache::CHUNK_SIZE);
+		const int chunksY = vstd::divideAndCeil(sizeY, TerrainChunkCache::CHUNK_SIZE);
+
+		for (int level = 0; level < static_cast<int>(levels); ++level)
+		{
+			for (int chunkX = 0; chunkX < chunksX; ++chunkX)
+			{
+				for (int chunkY = 0; chunkY < chunksY; ++chunkY)
+				{
+					// for chunks that receiver already has only objects on tiles are serialized
+					bool cached = false;
+					int64_t hash = 0;
+
+					if constexpr (Handler::saving)
+					{
+						if (h.knownTerrainChunks && !h.knownTerrainChunks->empty())
+						{
+							hash = TerrainChunkCache::chunkHash(terrain, level, chunkX, chunkY);
+							cached = h.knownTerrainChunks->count(hash);
+						}
+					}
+
+					h & cached;
+					if (cached)
+					{
+						h & hash;
+						if constexpr (!Handler::saving)
+						{
+							if (!h.terrainChunkCache || !h.terrainChunkCache->restore(hash, terrain, level, chunkX, chunkY))
+								throw std::runtime_error("Received unknown terrain chunk!");
+						}
+					}
+
+					const int endX = std::min<int>((chunkX + 1) * TerrainChunkCache::CHUNK_SIZE, sizeX);
+					const int endY = std::min<int>((chunkY + 1) * TerrainChunkCache::CHUNK_SIZE, sizeY);
+
+					for (int x = chunkX * TerrainChunkCache::CHUNK_SIZE; x < endX; ++x)
+					{
+						for (int y = chunkY * TerrainChunkCache::CHUNK_SIZE; y < endY; ++y)
+						{
+							TerrainTile & tile = terrain[level][x][y];
+							if (cached)
+							{
+								h & tile.visitable;
+								h & tile.blocked;
+								h & tile.visitableObjects;
+								h & tile.blockingObjects;
+							}
+							else
+								h & tile;
+						}
+					}
+				}
+			}
+		}
+	}
+
 public:
 	template <typename Handler>
 	void serialize(Handler &h)
@@ -210,7 +284,10 @@ public:
 		h & allHeroes;
 
 		//TODO: viccondetails
-		h & terrain;
+		if (h.version >= Handler::Version::TERRAIN_CHUNKS)
+			serializeTerrain(h);
+		else
+			h & terrain;
 		h & guardingCreaturePositions;
 
 		h & objects;
@@ -0,0 +1,144 @@
+/*
+ * TerrainChunkCache.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "TerrainChunkCache.h"
+
+#include "../RiverHandler.h"
+#include "../RoadHandler.h"
+#include "../TerrainHandler.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+template<typename Func>
+static void forEachChunkTile(const TerrainChunkCache::TerrainArray & terrain, int chunkX, int chunkY, const Func & func)
+{
+	const int endX = std::min<int>((chunkX + 1) * TerrainChunkCache::CHUNK_SIZE, terrain.shape()[1]);
+	const int endY = std::min<int>((chunkY + 1) * TerrainChunkCache::CHUNK_SIZE, terrain.shape()[2]);
+
+	for(int x = chunkX * TerrainChunkCache::CHUNK_SIZE; x < endX; ++x)
+		for(int y = chunkY * TerrainChunkCache::CHUNK_SIZE; y < endY; ++y)
+			func(x, y);
+}
+
+int64_t TerrainChunkCache::chunkHash(const TerrainArray & terrain, int level, int chunkX, int chunkY)
+{
+	// FNV-1a, same result on all platforms unlike std::hash
+	uint64_t hash = 14695981039346656037ULL;
+	auto combine = [&hash](int64_t value)
+	{
+		hash ^= static_cast<uint64_t>(value);
+		hash *= 1099511628211ULL;
+	};
+
+	combine(level);
+	combine(chunkX);
+	combine(chunkY);
+	forEachChunkTile(terrain, chunkX, chunkY, [&](int x, int y)
+	{
+		const TerrainTile & tile = terrain[level][x][y];
+		combine(tile.terType ? tile.terType->getIndex() : -1);
+		combine(tile.riverType ? tile.riverType->getIndex() : -1);
+		combine(tile.roadType ? tile.roadType->getIndex() : -1);
+		combine(tile.terView);
+		combine(tile.riverDir);
+		combine(tile.roadDir);
+		combine(tile.extTileFlags);
+	});
+
+	// hashes are serialized as signed integers
+	return static_cast<int64_t>(hash >> 1);
+}
+
+uint32_t TerrainChunkCache::store(const TerrainArray & terrain)
+{
+	++generation;
+
+	const int chunksX = vstd::divideAndCeil(terrain.shape()[1], CHUNK_SIZE);
+	const int chunksY = vstd::divideAndCeil(terrain.shape()[2], CHUNK_SIZE);
+
+	for(int level = 0; level < terrain.shape()[0]; ++level)
+	{
+		for(int chunkX = 0; chunkX < chunksX; ++chunkX)
+		{
+			for(int chunkY = 0; chunkY < chunksY; ++chunkY)
+			{
+				auto & chunk = chunks[chunkHash(terrain, level, chunkX, chunkY)];
+				chunk.generation = generation;
+				chunk.tiles.clear();
+				forEachChunkTile(terrain, chunkX, chunkY, [&](int x, int y)
+				{
+					chunk.tiles.push_back(terrain[level][x][y]);
+					chunk.tiles.back().visitableObjects.clear();
+					chunk.tiles.back().blockingObjects.clear();
+				});
+			}
+		}
+	}
+
+	prune(generation - 1);
+	return generation;
+}
+
+void TerrainChunkCache::prune(uint32_t oldestGeneration)
+{
+	for(auto it = chunks.begin(); it != chunks.end();)
+	{
+		if(it->second.generation < oldestGeneration)
+			it = chunks.erase(it);
+		else
+			++it;
+	}
+}
+
+bool TerrainChunkCache::restore(int64_t hash, TerrainArray & terrain, int level, int chunkX, int chunkY) const
+{
+	auto it = chunks.find(hash);
+	if(it == chunks.end())
+		return false;
+
+	const auto & tiles = it->second.tiles;
+	size_t index = 0;
+	bool sizeMatches = true;
+	forEachChunkTile(terrain, chunkX, chunkY, [&](int x, int y)
+	{
+		if(index >= tiles.size())
+		{
+			sizeMatches = false;
+			return;
+		}
+		terrain[level][x][y] = tiles[index++];
+	});
+
+	return sizeMatches && index == tiles.size();
+}
+
+std::vector<int64_t> TerrainChunkCache::getHashes() const
+{
+	std::vector<int64_t> result;
+	for(const auto & chunk : chunks)
+	{
+		if(chunk.second.generation == generation)
+			result.push_back(chunk.first);
+	}
+	return result;
+}
+
+uint32_t TerrainChunkCache::getGeneration() const
+{
+	return generation;
+}
+
+bool TerrainChunkCache::empty() const
+{
+	return chunks.empty();
+}
+
+VCMI_LIB_NAMESPACE_END
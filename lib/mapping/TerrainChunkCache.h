@@ -0,0 +1,54 @@
+/*
+ * TerrainChunkCache.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include "CMapDefines.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Static part of map terrain (terrain, rivers and roads) split into square chunks identified by hash of their content.
+/// Receiver that keeps chunks of previously received map may get only objects on tiles for chunks that did not change
+class DLL_LINKAGE TerrainChunkCache
+{
+public:
+	using TerrainArray = boost::multi_array<TerrainTile, 3>;
+	static constexpr int CHUNK_SIZE = 16;
+
+	/// Non-negative hash of static part of chunk, including its position and size
+	static int64_t chunkHash(const TerrainArray & terrain, int level, int chunkX, int chunkY);
+
+	/// Adds chunks of provided terrain to cache as new generation and returns its number
+	/// Chunks of previous generation are kept since other side may still expect them, older chunks are discarded
+	uint32_t store(const TerrainArray & terrain);
+	/// Discards chunks that are not part of specified or any newer generation
+	/// Should be called once other side acknowledged that it knows about chunks of this generation
+	void prune(uint32_t generation);
+	/// Copies static part of cached chunk into terrain, returns false if there is no such chunk
+	bool restore(int64_t hash, TerrainArray & terrain, int level, int chunkX, int chunkY) const;
+
+	/// Hashes of chunks of latest stored terrain
+	std::vector<int64_t> getHashes() const;
+	uint32_t getGeneration() const;
+	bool empty() const;
+
+private:
+	struct Chunk
+	{
+		std::vector<TerrainTile> tiles;
+		/// latest generation that contains this chunk
+		uint32_t generation = 0;
+	};
+
+	std::unordered_map<int64_t, Chunk> chunks;
+	uint32_t generation = 0;
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -465,13 +465,29 @@ void CModHandler::load()
 		allMods[modName].updateChecksum(calculateModChecksum(modName, CResourceHandler::get(modName)));
 	}
 
+	// preloaded data depends only on content of active mods, their load order, and validation mode
+	std::string contentCacheKey = settings["mods"]["validation"].String();
+	contentCacheKey += boost::str(boost::format(";%s:%08x") % coreMod->identifier % coreMod->getVerificationInfo().checksum);
+	for(const TModID & modName : activeMods)
+		contentCacheKey += boost::str(boost::format(";%s:%08x") % modName % allMods[modName].getVerificationInfo().checksum);
+
+	bool contentCacheLoaded = content->loadContentCache(contentCacheKey);
+	logMod->info("\tLoading content cache: %d ms", timer.getDiff());
+
 	// first - load virtual builtin mod that contains all data
 	// TODO? move all data into real mods? RoE, AB, SoD, WoG
-	content->preloadData(*coreMod);
+	std::vector<CModInfo *> modsToLoad = { coreMod.get() };
 	for(const TModID & modName : activeMods)
-		content->preloadData(allMods[modName]);
+		modsToLoad.push_back(&allMods[modName]);
+	content->preloadData(modsToLoad);
 	logMod->info("\tParsing mod data: %d ms", timer.getDiff());
 
+	if (!contentCacheLoaded)
+	{
+		content->saveContentCache(contentCacheKey);
+		logMod->info("\tSaving content cache: %d ms", timer.getDiff());
+	}
+
 	content->load(*coreMod);
 	for(const TModID & modName : activeMods)
 		content->load(allMods[modName]);
@@ -38,27 +38,35 @@
 #include "../rmg/CRmgTemplateStorage.h"
 #include "../spells/CSpellHandler.h"
 #include "../VCMI_Lib.h"
+#include "../VCMIDirs.h"
+#include "../serializer/CLoadFile.h"
+#include "../serializer/CSaveFile.h"
+
+#include <tbb/parallel_for.h>
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+static JsonNode loadOriginalData(IHandlerBase * handler)
+{
+	JsonNode result;
+	result.Vector() = handler->loadLegacyData();
+	result.setModScope(ModScope::scopeBuiltin());
+	return result;
+}
+
 ContentTypeHandler::ContentTypeHandler(IHandlerBase * handler, const std::string & entityName):
 	handler(handler),
 	entityName(entityName),
-	originalData(handler->loadLegacyData())
+	originalData(loadOriginalData(handler)),
+	originalDataUsed(originalData.root().size(), false)
 {
-	for(auto & node : originalData)
-	{
-		node.setModScope(ModScope::scopeBuiltin());
-	}
 }
 
-bool ContentTypeHandler::preloadModData(const std::string & modName, const JsonNode & fileList, bool validate)
+void ContentTypeHandler::preloadModData(const std::string & modName, JsonNode data)
 {
-	bool result = false;
-	JsonNode data = JsonUtils::assembleFromFiles(fileList, result);
 	data.setModScope(modName);
 
-	ModInfo & modInfo = modData[modName];
+	PreloadedModInfo & modInfo = preloadedData[modName];
 
 	for(auto entry : data.Struct())
 	{
@@ -79,7 +87,7 @@ bool ContentTypeHandler::preloadModData(const std::string & modName, const JsonN
 				logMod->warn("Redundant namespace definition for %s", objectName);
 
 			logMod->trace("Patching object %s (%s) from %s", objectName, remoteName, modName);
-			JsonNode & remoteConf = modData[remoteName].patches[objectName];
+			JsonNode & remoteConf = preloadedData[remoteName].patches[objectName];
 
 			if (!remoteConf.isNull() && settings["mods"]["validation"].String() != "off")
 				JsonUtils::detectConflicts(conflictList, remoteConf, entry.second, objectName);
@@ -87,12 +95,23 @@ bool ContentTypeHandler::preloadModData(const std::string & modName, const JsonN
 			JsonUtils::merge(remoteConf, entry.second);
 		}
 	}
-	return result;
+}
+
+void ContentTypeHandler::finishPreloading()
+{
+	for(auto & entry : preloadedData)
+	{
+		ModInfo & modInfo = modData[entry.first];
+		modInfo.modData = CompactJsonTree(entry.second.modData);
+		modInfo.patches = CompactJsonTree(entry.second.patches);
+	}
+	preloadedData.clear();
 }
 
 bool ContentTypeHandler::loadMod(const std::string & modName, bool validate)
 {
 	ModInfo & modInfo = modData[modName];
+	JsonNode loadedData = modInfo.modData.root().toJsonNode();
 	bool result = true;
 
 	auto performValidate = [&,this](JsonNode & data, const std::string & name){
@@ -102,10 +121,13 @@ bool ContentTypeHandler::loadMod(const std::string & modName, bool validate)
 	};
 
 	// apply patches
-	if (!modInfo.patches.isNull())
-		JsonUtils::merge(modInfo.modData, modInfo.patches);
+	if (!modInfo.patches.root().isNull())
+	{
+		JsonNode patches = modInfo.patches.root().toJsonNode();
+		JsonUtils::merge(loadedData, patches);
+	}
 
-	for(auto & entry : modInfo.modData.Struct())
+	for(auto & entry : loadedData.Struct())
 	{
 		const std::string & name = entry.first;
 		JsonNode & data = entry.second;
@@ -132,12 +154,16 @@ bool ContentTypeHandler::loadMod(const std::string & modName, bool validate)
 			// try to add H3 object data
 			size_t index = static_cast<size_t>(data["index"].Float());
 
-			if(originalData.size() > index)
+			if(originalData.root().size() > index)
 			{
 				logMod->trace("found original data in loadMod(%s) at index %d", name, index);
-				JsonUtils::merge(originalData[index], data);
-				std::swap(originalData[index], data);
-				originalData[index].clear(); // do not use same data twice (same ID)
+				if (!originalDataUsed[index]) // do not use same data twice (same ID)
+				{
+					JsonNode original = originalData.root()[index].toJsonNode();
+					JsonUtils::merge(original, data);
+					std::swap(original, data);
+					originalDataUsed[index] = true;
+				}
 			}
 			else
 			{
@@ -154,6 +180,9 @@ bool ContentTypeHandler::loadMod(const std::string & modName, bool validate)
 			handler->loadObject(modName, name, data);
 		}
 	}
+
+	// keep loaded objects, with patches and original data applied
+	modInfo.modData = CompactJsonTree(loadedData);
 	return result;
 }
 
@@ -162,16 +191,26 @@ void ContentTypeHandler::loadCustom()
 	handler->loadCustom();
 }
 
+void ContentTypeHandler::clearPreloadedData()
+{
+	preloadedData.clear();
+	modData.clear();
+	conflictList.clear();
+}
+
 void ContentTypeHandler::afterLoadFinalization()
 {
 	if (settings["mods"]["validation"].String() != "off")
 	{
 		for (auto const & data : modData)
 		{
-			if (data.second.modData.isNull())
+			const CompactJsonView objects = data.second.modData.root();
+			const CompactJsonView patches = data.second.patches.root();
+
+			if (objects.isNull())
 			{
-				for (auto node : data.second.patches.Struct())
-					logMod->warn("Mod '%s' have added patch for object '%s' from mod '%s', but this mod was not loaded or has no new objects.", node.second.getModScope(), node.first, data.first);
+				for (size_t i = 0; i < patches.size(); ++i)
+					logMod->warn("Mod '%s' have added patch for object '%s' from mod '%s', but this mod was not loaded or has no new objects.", patches.valueAt(i).getModScope(), patches.keyAt(i), data.first);
 			}
 
 			for(auto & otherMod : modData)
@@ -179,15 +218,15 @@ void ContentTypeHandler::afterLoadFinalization()
 				if (otherMod.first == data.first)
 					continue;
 
-				if (otherMod.second.modData.isNull())
-					continue;
+				const CompactJsonView otherObjects = otherMod.second.modData.root();
 
-				for(auto & otherObject : otherMod.second.modData.Struct())
+				for(size_t i = 0; i < otherObjects.size(); ++i)
 				{
-					if (data.second.modData.Struct().count(otherObject.first))
+					const std::string & otherObject = otherObjects.keyAt(i);
+					if (!objects[otherObject].isNull())
 					{
-						logMod->warn("Mod '%s' have added object with name '%s' that is also available in mod '%s'", data.first, otherObject.first, otherMod.first);
-						logMod->warn("Two objects with same name were loaded. Please use form '%s:%s' if mod '%s' needs to modify this object instead", otherMod.first, otherObject.first, data.first);
+						logMod->warn("Mod '%s' have added object with name '%s' that is also available in mod '%s'", data.first, otherObject, otherMod.first);
+						logMod->warn("Two objects with same name were loaded. Please use form '%s:%s' if mod '%s' needs to modify this object instead", otherMod.first, otherObject, data.first);
 					}
 				}
 			}
@@ -255,16 +294,6 @@ void CContentHandler::init()
 	handlers.insert(std::make_pair("biomes", ContentTypeHandler(VLC->biomeHandler.get(), "biome")));
 }
 
-bool CContentHandler::preloadModData(const std::string & modName, JsonNode modConfig, bool validate)
-{
-	bool result = true;
-	for(auto & handler : handlers)
-	{
-		result &= handler.second.preloadModData(modName, modConfig[handler.first], validate);
-	}
-	return result;
-}
-
 bool CContentHandler::loadMod(const std::string & modName, bool validate)
 {
 	bool result = true;
@@ -291,21 +320,75 @@ void CContentHandler::afterLoadFinalization()
 	}
 }
 
-void CContentHandler::preloadData(CModInfo & mod)
+void CContentHandler::preloadData(const std::vector<CModInfo *> & mods)
 {
-	bool validate = validateMod(mod);
+	const size_t handlersCount = handlers.size();
 
-	// print message in format [<8-symbols checksum>] <modname>
-	auto & info = mod.getVerificationInfo();
-	logMod->info("\t\t[%08x]%s", info.checksum, info.name);
+	std::vector<JsonNode> assembledData;
+	std::vector<uint8_t> assembledDataValid;
 
-	if (validate && mod.identifier != ModScope::scopeBuiltin())
+	if (!restoredFromCache)
 	{
-		if (!JsonUtils::validate(mod.config, "vcmi:mod", mod.identifier))
+		// reading and parsing of json files is independent for each mod and each content type
+		// while merging of parsed data must be done in load order, since mods may patch data of other mods
+		assembledData.resize(mods.size() * handlersCount);
+		assembledDataValid.resize(mods.size() * handlersCount);
+
+		std::vector<std::string> handlerNames;
+		for(const auto & handler : handlers)
+			handlerNames.push_back(handler.first);
+
+		tbb::parallel_for(tbb::blocked_range<size_t>(0, assembledData.size()), [&](const tbb::blocked_range<size_t> & range)
+		{
+			for(size_t i = range.begin(); i != range.end(); ++i)
+			{
+				const JsonNode & modConfig = mods[i / handlersCount]->config;
+				bool isValid = false;
+				assembledData[i] = JsonUtils::assembleFromFiles(modConfig[handlerNames[i % handlersCount]], isValid);
+				assembledDataValid[i] = isValid;
+			}
+		});
+	}
+
+	for(size_t modIndex = 0; modIndex < mods.size(); ++modIndex)
+	{
+		CModInfo & mod = *mods[modIndex];
+		bool validate = validateMod(mod);
+
+		// print message in format [<8-symbols checksum>] <modname>
+		auto & info = mod.getVerificationInfo();
+		logMod->info("\t\t[%08x]%s", info.checksum, info.name);
+
+		if (validate && mod.identifier != ModScope::scopeBuiltin())
+		{
+			if (!JsonUtils::validate(mod.config, "vcmi:mod", mod.identifier))
+				mod.validation = CModInfo::FAILED;
+		}
+
+		if (restoredFromCache)
+			continue;
+
+		bool result = true;
+		size_t handlerIndex = 0;
+		for(auto & handler : handlers)
+		{
+			size_t dataIndex = modIndex * handlersCount + handlerIndex++;
+			result &= assembledDataValid[dataIndex] != 0;
+			handler.second.preloadModData(mod.identifier, std::move(assembledData[dataIndex]));
+		}
+
+		if (!result)
+		{
 			mod.validation = CModInfo::FAILED;
+			preloadFailed = true;
+		}
 	}
-	if (!preloadModData(mod.identifier, mod.config, validate))
-		mod.validation = CModInfo::FAILED;
+
+	if (restoredFromCache)
+		return;
+
+	for(auto & handler : handlers)
+		handler.second.finishPreloading();
 }
 
 void CContentHandler::load(CModInfo & mod)
@@ -326,6 +409,80 @@ void CContentHandler::load(CModInfo & mod)
 		logMod->info("\t\t[SKIP] %s", mod.getVerificationInfo().name);
 }
 
+static boost::filesystem::path getContentCachePath()
+{
+	return VCMIDirs::get().userCachePath() / "modContentCache.vcmi";
+}
+
+bool CContentHandler::loadContentCache(const std::string & cacheKey)
+{
+	const auto path = getContentCachePath();
+
+	if (!boost::filesystem::exists(path))
+		return false;
+
+	try
+	{
+		CLoadFile file(path);
+
+		std::string storedKey;
+		file >> storedKey;
+
+		if (storedKey != cacheKey)
+		{
+			logMod->info("\tContent cache is outdated, all mods will be parsed");
+			return false;
+		}
+
+		for(auto & handler : handlers)
+		{
+			std::string storedName;
+			file >> storedName;
+			if (storedName != handler.first)
+				throw std::runtime_error("Unexpected content type " + storedName);
+
+			file >> handler.second;
+		}
+	}
+	catch(const std::exception & e)
+	{
+		logMod->warn("Failed to load content cache %s: %s", path.string(), e.what());
+
+		for(auto & handler : handlers)
+			handler.second.clearPreloadedData();
+		return false;
+	}
+
+	restoredFromCache = true;
+	return true;
+}
+
+void CContentHandler::saveContentCache(const std::string & cacheKey) const
+{
+	if (restoredFromCache || preloadFailed)
+		return;
+
+	const auto path = getContentCachePath();
+
+	try
+	{
+		// file is replaced atomically, so several game instances started at once would not read partially written cache
+		CSaveFile file(path);
+
+		file << cacheKey;
+		for(const auto & handler : handlers)
+		{
+			file << handler.first;
+			file << handler.second;
+		}
+		file.writeToDisk();
+	}
+	catch(const std::exception & e)
+	{
+		logMod->warn("Failed to save content cache %s: %s", path.string(), e.what());
+	}
+}
+
 const ContentTypeHandler & CContentHandler::operator[](const std::string & name) const
 {
 	return handlers.at(name);
@@ -9,7 +9,7 @@
  */
 #pragma once
 
-#include "../json/JsonNode.h"
+#include "../json/CompactJsonTree.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -21,49 +21,91 @@ class DLL_LINKAGE ContentTypeHandler
 {
 	JsonNode conflictList;
 
+	/// mod data that is still being preloaded, in the same form as ModInfo
+	struct PreloadedModInfo
+	{
+		JsonNode modData;
+		JsonNode patches;
+	};
+	std::map<std::string, PreloadedModInfo> preloadedData;
+
+	/// true for entries of originalData that were already used by some object
+	std::vector<bool> originalDataUsed;
+
 public:
+	/// read-only copy of mod data, converted to JsonNode only when data needs to be modified
 	struct ModInfo
 	{
 		/// mod data from this mod and for this mod
-		JsonNode modData;
+		CompactJsonTree modData;
 		/// mod data for this mod from other mods (patches)
-		JsonNode patches;
+		CompactJsonTree patches;
+
+		template <typename Handler> void serialize(Handler & h)
+		{
+			h & modData;
+			h & patches;
+		}
 	};
 	/// handler to which all data will be loaded
 	IHandlerBase * handler;
 	std::string entityName;
 
-	/// contains all loaded H3 data
-	std::vector<JsonNode> originalData;
+	/// contains all loaded H3 data, as vector with one entry per object
+	CompactJsonTree originalData;
 	std::map<std::string, ModInfo> modData;
 
 	ContentTypeHandler(IHandlerBase * handler, const std::string & objectName);
 
 	/// local version of methods in ContentHandler
+	/// data - content of all files of this type from this mod, assembled using JsonUtils::assembleFromFiles
+	void preloadModData(const std::string & modName, JsonNode data);
+	/// converts data of all preloaded mods into modData, must be called once all mods were preloaded
+	void finishPreloading();
 	/// returns true if loading was successful
-	bool preloadModData(const std::string & modName, const JsonNode & fileList, bool validate);
 	bool loadMod(const std::string & modName, bool validate);
 	void loadCustom();
 	void afterLoadFinalization();
+
+	/// discards all data loaded by preloadModData
+	void clearPreloadedData();
+
+	/// serializes state of handler after preloading of all mods, used for content cache
+	template <typename Handler> void serialize(Handler & h)
+	{
+		h & modData;
+		h & conflictList;
+	}
 };
 
 /// class used to load all game data into handlers. Used only during loading
 class DLL_LINKAGE CContentHandler
 {
-	/// preloads all data from fileList as data from modName.
-	bool preloadModData(const std::string & modName, JsonNode modConfig, bool validate);
-
 	/// actually loads data in mod
 	bool loadMod(const std::string & modName, bool validate);
 
 	std::map<std::string, ContentTypeHandler> handlers;
 
+	/// true if preloaded data of all mods was restored from content cache
+	bool restoredFromCache = false;
+	/// true if preloading of any of mods has failed, such data can not be cached
+	bool preloadFailed = false;
+
 	bool validateMod(const CModInfo & mod) const;
 public:
 	void init();
 
-	/// preloads all data from fileList as data from modName.
-	void preloadData(CModInfo & mod);
+	/// attempts to restore preloaded data of all mods from content cache
+	/// cacheKey must uniquely identify set of active mods and their content
+	/// returns true on success, in this case preloadData will skip parsing of mod files
+	bool loadContentCache(const std::string & cacheKey);
+
+	/// saves preloaded data of all mods into content cache, if it was not restored from it
+	void saveContentCache(const std::string & cacheKey) const;
+
+	/// preloads all data from fileList of all provided mods, in specified order
+	/// files are read and parsed in parallel, but merged in the same order as if mods were preloaded one by one
+	void preloadData(const std::vector<CModInfo *> & mods);
 
 	/// actually loads data in mod
 	void load(CModInfo & mod);
@@ -50,8 +50,7 @@ void NetworkConnection::start()
 void NetworkConnection::startReceiving()
 {
 	boost::asio::async_read(*socket,
-							readBuffer,
-							boost::asio::transfer_exactly(messageHeaderSize),
+							boost::asio::buffer(readHeader),
 							[self = shared_from_this()](const auto & ec, const auto & endpoint) { self->onHeaderReceived(ec); });
 }
 
@@ -82,11 +81,8 @@ void NetworkConnection::onHeaderReceived(const boost::system::error_code & ecHea
 		return;
 	}
 
-	if (readBuffer.size() < messageHeaderSize)
-		throw std::runtime_error("Failed to read header!");
-
 	uint32_t messageSize;
-	readBuffer.sgetn(reinterpret_cast<char *>(&messageSize), sizeof(messageSize));
+	std::memcpy(&messageSize, readHeader.data(), sizeof(messageSize));
 
 	if (messageSize > messageMaxSize)
 	{
@@ -101,9 +97,10 @@ void NetworkConnection::onHeaderReceived(const boost::system::error_code & ecHea
 		return;
 	}
 
+	// payload is read directly into buffer that is passed to listener. Buffer is reused for all packets
+	readBuffer.resize(messageSize);
 	boost::asio::async_read(*socket,
-							readBuffer,
-							boost::asio::transfer_exactly(messageSize),
+							boost::asio::buffer(readBuffer),
 							[self = shared_from_this(), messageSize](const auto & ecPayload, const auto & endpoint) { self->onPacketReceived(ecPayload, messageSize); });
 }
 
@@ -120,11 +117,16 @@ void NetworkConnection::onPacketReceived(const boost::system::error_code & ec, u
 		// FIXME: figure out what causes this. This should not be possible without error set
 		std::string errorMessage = "Failed to read packet! " + std::to_string(readBuffer.size()) + " bytes read, but " + std::to_string(expectedPacketSize) + " bytes expected!";
 		onError(errorMessage);
+		return;
 	}
 
-	std::vector<std::byte> message(expectedPacketSize);
-	readBuffer.sgetn(reinterpret_cast<char *>(message.data()), expectedPacketSize);
-	listener.onPacketReceived(shared_from_this(), message);
+	listener.onPacketReceived(shared_from_this(), readBuffer);
+
+	if (readBuffer.capacity() > retainedBufferMaxSize)
+	{
+		readBuffer.clear();
+		readBuffer.shrink_to_fit();
+	}
 
 	startReceiving();
 }
@@ -137,30 +139,36 @@ void NetworkConnection::setAsyncWritesEnabled(bool on)
 void NetworkConnection::sendPacket(const std::vector<std::byte> & message)
 {
 	std::lock_guard lock(writeMutex);
-	std::vector<std::byte> headerVector(sizeof(uint32_t));
 	uint32_t messageSize = message.size();
-	std::memcpy(headerVector.data(), &messageSize, sizeof(uint32_t));
+	const auto * header = reinterpret_cast<const std::byte *>(&messageSize);
 
 	// At the moment, vcmilobby *requires* async writes in order to handle multiple connections with different speeds and at optimal performance
 	// However server (and potentially - client) can not handle this mode and may shutdown either socket or entire asio service too early, before all writes are performed
 	if (asyncWritesEnabled)
 	{
+		if (dataToSend.size() + messageHeaderSize + message.size() > sendQueueMaxSize)
+		{
+			logNetwork->error("Too much data is waiting to be sent! Closing connection");
+			close();
+			return;
+		}
 
-		bool messageQueueEmpty = dataToSend.empty();
-		dataToSend.push_back(headerVector);
-		if (!message.empty())
-			dataToSend.push_back(message);
+		dataToSend.insert(dataToSend.end(), header, header + messageHeaderSize);
+		dataToSend.insert(dataToSend.end(), message.begin(), message.end());
 
-		if (messageQueueEmpty)
+		if (dataBeingSent.empty())
 			doSendData();
-		//else - data sending loop is still active and still sending previous messages
+		//else - data sending loop is still active, this message will be sent together with others once previous write is over
 	}
 	else
 	{
+		std::array<boost::asio::const_buffer, 2> buffers = {
+			boost::asio::buffer(header, messageHeaderSize),
+			boost::asio::buffer(message)
+		};
+
 		boost::system::error_code ec;
-		boost::asio::write(*socket, boost::asio::buffer(headerVector), ec );
-		if (!message.empty())
-			boost::asio::write(*socket, boost::asio::buffer(message), ec );
+		boost::asio::write(*socket, buffers, ec );
 	}
 }
 
@@ -169,7 +177,10 @@ void NetworkConnection::doSendData()
 	if (dataToSend.empty())
 		throw std::runtime_error("Attempting to sent data but there is no data to send!");
 
-	boost::asio::async_write(*socket, boost::asio::buffer(dataToSend.front()), [self = shared_from_this()](const auto & error, const auto & )
+	// all messages queued so far are sent in a single write
+	std::swap(dataToSend, dataBeingSent);
+
+	boost::asio::async_write(*socket, boost::asio::buffer(dataBeingSent), [self = shared_from_this()](const auto & error, const auto & )
 	{
 		self->onDataSent(error);
 	});
@@ -178,7 +189,11 @@ void NetworkConnection::doSendData()
 void NetworkConnection::onDataSent(const boost::system::error_code & ec)
 {
 	std::lock_guard lock(writeMutex);
-	dataToSend.pop_front();
+	dataBeingSent.clear();
+
+	if (dataBeingSent.capacity() > retainedBufferMaxSize)
+		dataBeingSent.shrink_to_fit();
+
 	if (ec)
 	{
 		onError(ec.message());
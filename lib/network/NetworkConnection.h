@@ -17,13 +17,19 @@ class NetworkConnection final : public INetworkConnection, public std::enable_sh
 {
 	static const int messageHeaderSize = sizeof(uint32_t);
 	static const int messageMaxSize = 64 * 1024 * 1024; // arbitrary size to prevent potential massive allocation if we receive garbage input
+	static const int sendQueueMaxSize = 2 * messageMaxSize; // connection that can't keep up with sent data is closed once this is reached
+	static const int retainedBufferMaxSize = 1024 * 1024; // buffers that grew above this size are released after use
 
-	std::list<std::vector<std::byte>> dataToSend;
+	/// Messages with headers that were queued while previous write was in progress
+	std::vector<std::byte> dataToSend;
+	/// Data that is currently being written. Swapped with dataToSend once write is over, so both buffers are reused
+	std::vector<std::byte> dataBeingSent;
 	std::shared_ptr<NetworkSocket> socket;
 	std::shared_ptr<NetworkTimer> timer;
 	std::mutex writeMutex;
 
-	NetworkBuffer readBuffer;
+	std::array<std::byte, messageHeaderSize> readHeader;
+	std::vector<std::byte> readBuffer;
 	INetworkConnectionListener & listener;
 	bool asyncWritesEnabled = false;
 
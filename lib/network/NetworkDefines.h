@@ -18,7 +18,6 @@ VCMI_LIB_NAMESPACE_BEGIN
 using NetworkContext = boost::asio::io_service;
 using NetworkSocket = boost::asio::ip::tcp::socket;
 using NetworkAcceptor = boost::asio::ip::tcp::acceptor;
-using NetworkBuffer = boost::asio::streambuf;
 using NetworkTimer = boost::asio::steady_timer;
 
 VCMI_LIB_NAMESPACE_END
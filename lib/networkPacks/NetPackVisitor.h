@@ -178,6 +178,8 @@ public:
 	virtual void visitLobbyForceSetPlayer(LobbyForceSetPlayer & pack) {}
 	virtual void visitLobbyShowMessage(LobbyShowMessage & pack) {}
 	virtual void visitLobbyPvPAction(LobbyPvPAction & pack) {}
+	virtual void visitLobbyCachedTerrainChunks(LobbyCachedTerrainChunks & pack) {}
+	virtual void visitLobbyCachedTerrainChunksAccepted(LobbyCachedTerrainChunksAccepted & pack) {}
 	virtual void visitSaveLocalState(SaveLocalState & pack) {}
 };
 
@@ -842,6 +842,16 @@ void LobbyPvPAction::visitTyped(ICPackVisitor & visitor)
 	visitor.visitLobbyPvPAction(*this);
 }
 
+void LobbyCachedTerrainChunks::visitTyped(ICPackVisitor & visitor)
+{
+	visitor.visitLobbyCachedTerrainChunks(*this);
+}
+
+void LobbyCachedTerrainChunksAccepted::visitTyped(ICPackVisitor & visitor)
+{
+	visitor.visitLobbyCachedTerrainChunksAccepted(*this);
+}
+
 void SetResources::applyGs(CGameState *gs)
 {
 	assert(player.isValidPlayer());
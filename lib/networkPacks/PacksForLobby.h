@@ -381,4 +381,34 @@ struct DLL_LINKAGE LobbyPvPAction : public CLobbyPackToServer
 	}
 };
 
+/// Sent by client to let server know which terrain chunks it has from previously received map
+struct DLL_LINKAGE LobbyCachedTerrainChunks : public CLobbyPackToServer
+{
+	std::vector<int64_t> hashes;
+	/// generation of terrain chunk cache these hashes belong to, 0 if client does not expect acknowledgement
+	uint32_t generation = 0;
+
+	void visitTyped(ICPackVisitor & visitor) override;
+
+	template <typename Handler> void serialize(Handler &h)
+	{
+		h & hashes;
+		if (h.version >= Handler::Version::TERRAIN_CHUNK_GENERATIONS)
+			h & generation;
+	}
+};
+
+/// Sent by server once it will no longer use terrain chunks of generations older than specified one
+struct DLL_LINKAGE LobbyCachedTerrainChunksAccepted : public CLobbyPackToPropagate
+{
+	uint32_t generation = 0;
+
+	void visitTyped(ICPackVisitor & visitor) override;
+
+	template <typename Handler> void serialize(Handler &h)
+	{
+		h & generation;
+	}
+};
+
 VCMI_LIB_NAMESPACE_END
@@ -55,11 +55,32 @@ int3 CGPath::endPos() const
 CPathsInfo::CPathsInfo(const int3 & Sizes, const CGHeroInstance * hero_)
 	: sizes(Sizes), hero(hero_)
 {
-	nodes.resize(boost::extents[ELayer::NUM_LAYERS][sizes.z][sizes.x][sizes.y]);
+	layerIndex.fill(-1);
+	allocateLayers({true, false, false, false});
 }
 
 CPathsInfo::~CPathsInfo() = default;
 
+bool CPathsInfo::allocateLayers(const TLayerSet & layers)
+{
+	std::array<int8_t, ELayer::NUM_LAYERS> newIndex;
+	int8_t count = 0;
+
+	for(int i = 0; i < ELayer::NUM_LAYERS; i++)
+		newIndex[i] = layers[i] ? count++ : -1;
+
+	if(newIndex == layerIndex)
+		return false;
+
+	layerIndex = newIndex;
+	snapshot = PathsSnapshot();
+
+	// nodes remember their layer on first update so they can not be reused by another layer
+	nodes.resize(boost::extents[0][0][0][0]);
+	nodes.resize(boost::extents[count][sizes.z][sizes.x][sizes.y]);
+	return true;
+}
+
 const CGPathNode * CPathsInfo::getPathInfo(const int3 & tile) const
 {
 	assert(vstd::iswithin(tile.x, 0, sizes.x));
@@ -87,11 +108,11 @@ bool CPathsInfo::getPath(CGPath & out, const int3 & dst) const
 
 const CGPathNode * CPathsInfo::getNode(const int3 & coord) const
 {
-	const auto * landNode = &nodes[ELayer::LAND][coord.z][coord.x][coord.y];
-	if(landNode->reachable())
+	const auto * landNode = &nodes[layerIndex[ELayer::LAND]][coord.z][coord.x][coord.y];
+	if(landNode->reachable() || !hasLayer(ELayer::SAIL))
 		return landNode;
 	else
-		return &nodes[ELayer::SAIL][coord.z][coord.x][coord.y];
+		return &nodes[layerIndex[ELayer::SAIL]][coord.z][coord.x][coord.y];
 }
 
 PathNodeInfo::PathNodeInfo()
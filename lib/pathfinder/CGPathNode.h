@@ -9,11 +9,11 @@
  */
 #pragma once
 
+#include "INodeQueue.h"
+#include "PathfinderOptions.h"
 #include "../GameConstants.h"
 #include "../int3.h"
 
-#include <boost/heap/fibonacci_heap.hpp>
-
 VCMI_LIB_NAMESPACE_BEGIN
 
 class CGHeroInstance;
@@ -59,11 +59,11 @@ enum class EPathNodeAction : ui8
 
 struct DLL_LINKAGE CGPathNode
 {
-	using TFibHeap = boost::heap::fibonacci_heap<CGPathNode *, boost::heap::compare<NodeComparer<CGPathNode>>>;
 	using ELayer = EPathfindingLayer;
 
-	TFibHeap::handle_type pqHandle;
-	TFibHeap * pq;
+	// Fields are ordered by size to avoid padding, paths info holds one node per tile and layer
+
+	INodeQueue * pq;
 	CGPathNode * theNodeBefore;
 
 	int3 coord; //coordinates
@@ -71,6 +71,7 @@ struct DLL_LINKAGE CGPathNode
 
 	float cost; //total cost of the path to this tile measured in turns with fractions
 	int moveRemains; //remaining movement points after hero reaches the tile
+	uint32_t pqIndex; // position of this node inside queue, only valid if node is in queue
 	ui8 turns; //how many turns we have to wait before reaching the tile - 0 means current turn
 	EPathAccessibility accessible;
 	EPathNodeAction action;
@@ -79,7 +80,7 @@ struct DLL_LINKAGE CGPathNode
 	CGPathNode()
 		: coord(-1),
 		layer(ELayer::WRONG),
-		pqHandle(nullptr)
+		pqIndex(0)
 	{
 		reset();
 	}
@@ -115,20 +116,10 @@ struct DLL_LINKAGE CGPathNode
 		if(vstd::isAlmostEqual(value, cost))
 			return;
 
-		bool getUpNode = value < cost;
 		cost = value;
-		// If the node is in the heap, update the heap.
+		// If the node is in the queue, update its position.
 		if(inPQ())
-		{
-			if(getUpNode)
-			{
-				pq->increase(this->pqHandle);
-			}
-			else
-			{
-				pq->decrease(this->pqHandle);
-			}
-		}
+			pq->update(this);
 	}
 
 	STRONG_INLINE
@@ -181,14 +172,43 @@ struct DLL_LINKAGE CGPath
 	int3 endPos() const; //destination point
 };
 
+/// Objects and guards on tile that may affect pathfinder rules but are not reflected in node accessibility
+struct DLL_LINKAGE TileSnapshot
+{
+	struct VisitableObject
+	{
+		ObjectInstanceID id;
+		PlayerColor owner;
+	};
+
+	int3 guardPos;
+	std::vector<VisitableObject> visitableObjects;
+};
+
+/// State of map and hero at moment of last paths calculation
+/// Allows node storage to repair previous paths after small changes instead of calculating them from scratch
+struct DLL_LINKAGE PathsSnapshot
+{
+	const CGHeroInstance * hero = nullptr; // nullptr if paths were not calculated yet
+	int64_t heroBonusVersion = 0;
+	std::optional<PathfinderOptions> options;
+	int day = 0;
+	std::vector<TileSnapshot> tiles; //[level][w][h]
+};
+
 struct DLL_LINKAGE CPathsInfo
 {
 	using ELayer = EPathfindingLayer;
 
+	using TLayerSet = std::array<bool, ELayer::NUM_LAYERS>;
+
 	const CGHeroInstance * hero;
 	int3 hpos;
 	int3 sizes;
-	boost::multi_array<CGPathNode, 4> nodes; //[layer][level][w][h]
+	/// [allocated layer][level][w][h]
+	/// Nodes are not split into separate per-field arrays, since pathfinder rules, AI and CGPath keep pointers to them
+	boost::multi_array<CGPathNode, 4> nodes;
+	PathsSnapshot snapshot;
 
 	CPathsInfo(const int3 & Sizes, const CGHeroInstance * hero_);
 	~CPathsInfo();
@@ -196,11 +216,30 @@ struct DLL_LINKAGE CPathsInfo
 	bool getPath(CGPath & out, const int3 & dst) const;
 	const CGPathNode * getNode(const int3 & coord) const;
 
+	/// Allocates nodes only for layers that can be used by hero, layers that are not allocated can not be accessed
+	/// Nodes are reallocated only if set of layers has changed since last call, returns true in this case
+	bool allocateLayers(const TLayerSet & layers);
+
+	STRONG_INLINE
+	bool hasLayer(const ELayer layer) const
+	{
+		return layerIndex[layer.getNum()] >= 0;
+	}
+
+	/// Returns nullptr if layer was not allocated
 	STRONG_INLINE
 	CGPathNode * getNode(const int3 & coord, const ELayer layer)
 	{
-		return &nodes[layer.getNum()][coord.z][coord.x][coord.y];
+		int index = layerIndex[layer.getNum()];
+
+		if(index < 0)
+			return nullptr;
+
+		return &nodes[index][coord.z][coord.x][coord.y];
 	}
+
+private:
+	std::array<int8_t, ELayer::NUM_LAYERS> layerIndex; // position of layer in nodes array or -1 if layer is not allocated
 };
 
 struct DLL_LINKAGE PathNodeInfo
@@ -11,6 +11,7 @@
 #include "CPathfinder.h"
 
 #include "INodeStorage.h"
+#include "NodeQueue.h"
 #include "PathfinderOptions.h"
 #include "PathfindingRules.h"
 #include "TurnInfo.h"
@@ -76,6 +77,8 @@ CPathfinder::CPathfinder(CGameState * _gs, std::shared_ptr<PathfinderConfig> con
 	gamestate(_gs),
 	config(std::move(config))
 {
+	pq = std::make_unique<NodeHeapQueue>();
+
 	initializeGraph();
 }
 
@@ -83,20 +86,12 @@ CPathfinder::CPathfinder(CGameState * _gs, std::shared_ptr<PathfinderConfig> con
 void CPathfinder::push(CGPathNode * node)
 {
 	if(node && !node->inPQ())
-	{
-		node->pq = &this->pq;
-		auto handle = pq.push(node);
-		node->pqHandle = handle;
-	}
+		pq->push(node);
 }
 
 CGPathNode * CPathfinder::topAndPop()
 {
-	auto * node = pq.top();
-
-	pq.pop();
-	node->pq = nullptr;
-	return node;
+	return pq->topAndPop();
 }
 
 void CPathfinder::calculatePaths()
@@ -121,12 +116,12 @@ void CPathfinder::calculatePaths()
 		if(hlp->isHeroPatrolLocked())
 			continue;
 
-		pq.push(initialNode);
+		push(initialNode);
 	}
 
 	std::vector<CGPathNode *> neighbourNodes;
 
-	while(!pq.empty())
+	while(!pq->empty())
 	{
 		counter++;
 		auto * node = topAndPop();
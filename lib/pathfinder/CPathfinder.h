@@ -48,7 +48,7 @@ private:
 
 	std::shared_ptr<PathfinderConfig> config;
 
-	boost::heap::fibonacci_heap<CGPathNode *, boost::heap::compare<NodeComparer<CGPathNode>> > pq;
+	std::unique_ptr<INodeQueue> pq;
 
 	PathNodeInfo source; //current (source) path node -> we took it from the queue
 	CDestinationNodeInfo destination; //destination node -> it's a neighbour of source that we consider
@@ -0,0 +1,31 @@
+/*
+ * INodeQueue.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+struct CGPathNode;
+
+/// Priority queue of path nodes that are waiting for processing, node with lowest cost is processed first
+/// Queue stores its own position of node inside node itself, so cost of queued node can be changed cheaply
+class DLL_LINKAGE INodeQueue
+{
+public:
+	virtual ~INodeQueue() = default;
+
+	virtual bool empty() const = 0;
+	virtual void push(CGPathNode * node) = 0;
+	virtual CGPathNode * topAndPop() = 0;
+
+	/// Restores queue order after cost of queued node has been changed
+	virtual void update(CGPathNode * node) = 0;
+};
+
+VCMI_LIB_NAMESPACE_END
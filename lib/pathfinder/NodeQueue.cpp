@@ -0,0 +1,111 @@
+/*
+ * NodeQueue.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+#include "NodeQueue.h"
+
+#include "CGPathNode.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+void NodeHeapQueue::place(CGPathNode * node, uint32_t index)
+{
+	nodes[index] = node;
+	node->pqIndex = index;
+}
+
+void NodeHeapQueue::siftUp(uint32_t index)
+{
+	CGPathNode * node = nodes[index];
+
+	while(index > 0)
+	{
+		uint32_t parent = (index - 1) / ARITY;
+
+		if(nodes[parent]->getCost() <= node->getCost())
+			break;
+
+		place(nodes[parent], index);
+		index = parent;
+	}
+
+	place(node, index);
+}
+
+void NodeHeapQueue::siftDown(uint32_t index)
+{
+	CGPathNode * node = nodes[index];
+	const auto count = static_cast<uint32_t>(nodes.size());
+
+	while(true)
+	{
+		uint32_t firstChild = index * ARITY + 1;
+
+		if(firstChild >= count)
+			break;
+
+		uint32_t lastChild = std::min(firstChild + ARITY, count);
+		uint32_t bestChild = firstChild;
+
+		for(uint32_t child = firstChild + 1; child < lastChild; ++child)
+		{
+			if(nodes[child]->getCost() < nodes[bestChild]->getCost())
+				bestChild = child;
+		}
+
+		if(node->getCost() <= nodes[bestChild]->getCost())
+			break;
+
+		place(nodes[bestChild], index);
+		index = bestChild;
+	}
+
+	place(node, index);
+}
+
+bool NodeHeapQueue::empty() const
+{
+	return nodes.empty();
+}
+
+void NodeHeapQueue::push(CGPathNode * node)
+{
+	node->pq = this;
+	nodes.push_back(node);
+	siftUp(static_cast<uint32_t>(nodes.size() - 1));
+}
+
+CGPathNode * NodeHeapQueue::topAndPop()
+{
+	CGPathNode * result = nodes.front();
+	CGPathNode * last = nodes.back();
+
+	nodes.pop_back();
+	result->pq = nullptr;
+
+	if(last != result)
+	{
+		place(last, 0);
+		siftDown(0);
+	}
+
+	return result;
+}
+
+void NodeHeapQueue::update(CGPathNode * node)
+{
+	uint32_t index = node->pqIndex;
+
+	if(index > 0 && nodes[(index - 1) / ARITY]->getCost() > node->getCost())
+		siftUp(index);
+	else
+		siftDown(index);
+}
+
+VCMI_LIB_NAMESPACE_END
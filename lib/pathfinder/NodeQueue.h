@@ -0,0 +1,35 @@
+/*
+ * NodeQueue.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#pragma once
+
+#include "INodeQueue.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Indexed 4-ary min-heap of path nodes stored in contiguous array
+/// Position of each node in array is stored in CGPathNode::pqIndex
+class DLL_LINKAGE NodeHeapQueue final : public INodeQueue
+{
+	static constexpr uint32_t ARITY = 4;
+
+	std::vector<CGPathNode *> nodes;
+
+	void place(CGPathNode * node, uint32_t index);
+	void siftUp(uint32_t index);
+	void siftDown(uint32_t index);
+
+public:
+	bool empty() const override;
+	void push(CGPathNode * node) override;
+	CGPathNode * topAndPop() override;
+	void update(CGPathNode * node) override;
+};
+
+VCMI_LIB_NAMESPACE_END
@@ -18,21 +18,109 @@
 #include "../mapObjects/CGHeroInstance.h"
 #include "../mapObjects/MiscObjects.h"
 #include "../mapping/CMap.h"
+#include "../spells/CSpellHandler.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
-void NodeStorage::initialize(const PathfinderOptions & options, const CGameState * gs)
+/// Layers that hero may enter during pathfinding, must include every layer that CPathfinderHelper::isLayerAvailable allows
+static CPathsInfo::TLayerSet requiredLayers(const PathfinderOptions & options, const CGameState * gs, const CGHeroInstance * hero)
 {
-	//TODO: fix this code duplication with AINodeStorage::initialize, problem is to keep `resetTile` inline
+	CPathsInfo::TLayerSet layers = {};
+	const EPathfindingLayer boatLayer = hero->boat ? hero->boat->layer : EPathfindingLayer::WRONG;
+
+	layers[EPathfindingLayer::LAND] = true;
+	layers[EPathfindingLayer::SAIL] = boatLayer == EPathfindingLayer::SAIL;
+
+	if(options.useEmbarkAndDisembark && !layers[EPathfindingLayer::SAIL])
+	{
+		for(const auto & object : gs->map->objects)
+		{
+			if(object && object->ID == Obj::BOAT)
+			{
+				layers[EPathfindingLayer::SAIL] = true;
+				break;
+			}
+		}
+	}
+
+	if(options.useFlying)
+	{
+		layers[EPathfindingLayer::AIR] = boatLayer == EPathfindingLayer::AIR
+			|| hero->hasBonusOfType(BonusType::FLYING_MOVEMENT)
+			|| (options.canUseCast && hero->canCastThisSpell(SpellID(SpellID::FLY).toSpell()));
+	}
+
+	if(options.useWaterWalking)
+	{
+		layers[EPathfindingLayer::WATER] = boatLayer == EPathfindingLayer::WATER
+			|| hero->hasBonusOfType(BonusType::WATER_WALKING)
+			|| (options.canUseCast && hero->canCastThisSpell(SpellID(SpellID::WATER_WALK).toSpell()));
+	}
+
+	return layers;
+}
+
+/// Options that may change results of search, queue type is not one of them
+static bool sameOptions(const PathfinderOptions & left, const PathfinderOptions & right)
+{
+	return left.useFlying == right.useFlying
+		&& left.useWaterWalking == right.useWaterWalking
+		&& left.ignoreGuards == right.ignoreGuards
+		&& left.useEmbarkAndDisembark == right.useEmbarkAndDisembark
+		&& left.useTeleportTwoWay == right.useTeleportTwoWay
+		&& left.useTeleportOneWay == right.useTeleportOneWay
+		&& left.useTeleportOneWayRandom == right.useTeleportOneWayRandom
+		&& left.useTeleportWhirlpool == right.useTeleportWhirlpool
+		&& left.forceUseTeleportWhirlpool == right.forceUseTeleportWhirlpool
+		&& left.useCastleGate == right.useCastleGate
+		&& left.lightweightFlyingMode == right.lightweightFlyingMode
+		&& left.oneTurnSpecialLayersLimit == right.oneTurnSpecialLayersLimit
+		&& left.originalFlyRules == right.originalFlyRules
+		&& left.turnLimit == right.turnLimit
+		&& left.canUseCast == right.canUseCast
+		&& left.allowLayerTransitioningAfterBattle == right.allowLayerTransitioningAfterBattle;
+}
+
+/// Stores current guard and visitable objects of tile into snapshot, returns true if they are different from stored ones
+static bool updateTileSnapshot(TileSnapshot & snapshot, const int3 & pos, const TerrainTile & tile, const CGameState * gs)
+{
+	const int3 guardPos = gs->guardingCreaturePosition(pos);
+	bool changed = snapshot.guardPos != guardPos || snapshot.visitableObjects.size() != tile.visitableObjects.size();
+
+	for(size_t i = 0; i < tile.visitableObjects.size() && !changed; ++i)
+	{
+		const CGObjectInstance * obj = tile.visitableObjects[i];
+		changed = snapshot.visitableObjects[i].id != obj->id || snapshot.visitableObjects[i].owner != obj->tempOwner;
+	}
+
+	if(changed)
+	{
+		snapshot.guardPos = guardPos;
+		snapshot.visitableObjects.clear();
+		for(const CGObjectInstance * obj : tile.visitableObjects)
+			snapshot.visitableObjects.push_back({obj->id, obj->tempOwner});
+	}
 
+	return changed;
+}
+
+static size_t tileIndex(const int3 & pos, const int3 & sizes)
+{
+	return (pos.z * sizes.x + pos.x) * sizes.y + pos.y;
+}
+
+template<typename TileHandler, typename NodeHandler>
+void NodeStorage::forEachNode(const CGameState * gs, const TileHandler & tileHandler, const NodeHandler & nodeHandler)
+{
 	int3 pos;
 	const PlayerColor player = out.hero->tempOwner;
 	const int3 sizes = gs->getMapSize();
 	const auto & fow = static_cast<const CGameInfoCallback *>(gs)->getPlayerTeam(player)->fogOfWarMap;
 
 	//make 200% sure that these are loop invariants (also a bit shorter code), let compiler do the rest(loop unswitching)
-	const bool useFlying = options.useFlying;
-	const bool useWaterWalking = options.useWaterWalking;
+	const bool useSailing = out.hasLayer(ELayer::SAIL);
+	const bool useFlying = out.hasLayer(ELayer::AIR);
+	const bool useWaterWalking = out.hasLayer(ELayer::WATER);
 
 	for(pos.z=0; pos.z < sizes.z; ++pos.z)
 	{
@@ -41,25 +129,214 @@ void NodeStorage::initialize(const PathfinderOptions & options, const CGameState
 			for(pos.y=0; pos.y < sizes.y; ++pos.y)
 			{
 				const TerrainTile & tile = gs->map->getTile(pos);
+				tileHandler(pos, tile);
+
 				if(tile.terType->isWater())
 				{
-					resetTile(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
+					if(useSailing)
+						nodeHandler(pos, ELayer::SAIL, PathfinderUtil::evaluateAccessibility<ELayer::SAIL>(pos, tile, fow, player, gs));
 					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+						nodeHandler(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
 					if(useWaterWalking)
-						resetTile(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
+						nodeHandler(pos, ELayer::WATER, PathfinderUtil::evaluateAccessibility<ELayer::WATER>(pos, tile, fow, player, gs));
 				}
 				if(tile.terType->isLand())
 				{
-					resetTile(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
+					nodeHandler(pos, ELayer::LAND, PathfinderUtil::evaluateAccessibility<ELayer::LAND>(pos, tile, fow, player, gs));
 					if(useFlying)
-						resetTile(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
+						nodeHandler(pos, ELayer::AIR, PathfinderUtil::evaluateAccessibility<ELayer::AIR>(pos, tile, fow, player, gs));
 				}
 			}
 		}
 	}
 }
 
+void NodeStorage::initialize(const PathfinderOptions & options, const CGameState * gs)
+{
+	//TODO: fix this code duplication with AINodeStorage::initialize, problem is to keep `resetTile` inline
+
+	out.allocateLayers(requiredLayers(options, gs, out.hero));
+	repairSeeds.clear();
+
+	PathsSnapshot & snapshot = out.snapshot;
+	CGPathNode * root = getNode(out.hpos, out.hero->boat ? out.hero->boat->layer : EPathfindingLayer::LAND);
+	const int64_t heroBonusVersion = out.hero->getTreeVersion();
+	const int day = gs->getDate(Date::DAY);
+
+	const bool canRepair = snapshot.hero == out.hero
+		&& snapshot.heroBonusVersion == heroBonusVersion
+		&& snapshot.options
+		&& sameOptions(*snapshot.options, options)
+		&& snapshot.day == day
+		&& !out.hero->patrol.patrolling
+		&& root->reachable()
+		&& root->turns == 0
+		&& root->moveRemains == out.hero->movementPointsRemaining()
+		&& !root->isTeleportAction();
+
+	if(canRepair)
+		repairGraph(gs, root);
+	else
+		resetGraph(gs);
+
+	snapshot.hero = out.hero;
+	snapshot.heroBonusVersion = heroBonusVersion;
+	snapshot.options = options;
+	snapshot.day = day;
+}
+
+void NodeStorage::resetGraph(const CGameState * gs)
+{
+	const int3 sizes = gs->getMapSize();
+	auto & tiles = out.snapshot.tiles;
+
+	tiles.resize(sizes.z * sizes.x * sizes.y);
+
+	forEachNode(gs,
+		[&](const int3 & pos, const TerrainTile & tile)
+		{
+			updateTileSnapshot(tiles[tileIndex(pos, sizes)], pos, tile, gs);
+		},
+		[&](const int3 & pos, const EPathfindingLayer & layer, EPathAccessibility accessibility)
+		{
+			resetTile(pos, layer, accessibility);
+		});
+}
+
+void NodeStorage::repairGraph(const CGameState * gs, CGPathNode * root)
+{
+	enum class ENodeState : ui8
+	{
+		UNKNOWN, // unreachable in previous search and not changed since
+		VALID, // path from new root is not affected by changes
+		INVALID // node was changed or path to it was not going through new root or through changed node
+	};
+
+	const int3 sizes = gs->getMapSize();
+	const float rootCost = root->getCost();
+	CGPathNode * const firstNode = out.nodes.data();
+	const size_t nodesCount = out.nodes.num_elements();
+	auto & tiles = out.snapshot.tiles;
+	std::vector<ENodeState> states(nodesCount, ENodeState::UNKNOWN);
+	bool tileChanged = false;
+
+	forEachNode(gs,
+		[&](const int3 & pos, const TerrainTile & tile)
+		{
+			tileChanged = updateTileSnapshot(tiles[tileIndex(pos, sizes)], pos, tile, gs);
+		},
+		[&](const int3 & pos, const EPathfindingLayer & layer, EPathAccessibility accessibility)
+		{
+			CGPathNode * node = getNode(pos, layer);
+
+			if(node == root)
+			{
+				// hero is now standing on this tile, but root always starts the search
+				node->accessible = accessibility;
+			}
+			else if(tileChanged || node->accessible != accessibility || node->layer != layer)
+			{
+				states[node - firstNode] = ENodeState::INVALID;
+				resetTile(pos, layer, accessibility);
+			}
+		});
+
+	// Node keeps its path only if it is descendant of new root in previous search tree and there are no changed nodes in between
+	// Teleport exits may have changed without any changes to tiles so nodes behind them are always recalculated
+	states[root - firstNode] = ENodeState::VALID;
+	std::vector<CGPathNode *> chain;
+
+	for(size_t i = 0; i < nodesCount; i++)
+	{
+		CGPathNode * node = firstNode + i;
+
+		if(states[i] != ENodeState::UNKNOWN || !node->reachable())
+			continue;
+
+		ENodeState result = ENodeState::INVALID;
+		chain.clear();
+
+		for(CGPathNode * current = node; current; current = current->theNodeBefore)
+		{
+			ENodeState state = states[current - firstNode];
+
+			if(state != ENodeState::UNKNOWN)
+			{
+				result = state;
+				break;
+			}
+
+			chain.push_back(current);
+
+			if(current->isTeleportAction())
+				break;
+		}
+
+		for(CGPathNode * chainNode : chain)
+			states[chainNode - firstNode] = result;
+	}
+
+	for(size_t i = 0; i < nodesCount; i++)
+	{
+		CGPathNode * node = firstNode + i;
+
+		if(states[i] == ENodeState::VALID)
+		{
+			node->cost -= rootCost;
+			node->locked = false;
+		}
+		else if(states[i] == ENodeState::INVALID && node->reachable())
+		{
+			node->update(node->coord, node->layer, node->accessible);
+		}
+	}
+
+	// Only valid nodes next to recalculated ones may give them a path, the rest were already expanded into valid nodes
+	// Nodes on visitable tiles are expanded as well since teleport exits may lead anywhere
+	static const int3 dirs[] = {
+		int3(-1, +1, +0),	int3(0, +1, +0),	int3(+1, +1, +0),
+		int3(-1, +0, +0),	/* source pos */	int3(+1, +0, +0),
+		int3(-1, -1, +0),	int3(0, -1, +0),	int3(+1, -1, +0)
+	};
+
+	for(size_t i = 0; i < nodesCount; i++)
+	{
+		CGPathNode * node = firstNode + i;
+
+		if(states[i] != ENodeState::VALID || node == root)
+			continue;
+
+		bool isBorder = gs->map->getTile(node->coord).visitable;
+
+		for(const auto & dir : dirs)
+		{
+			const int3 neighbour = node->coord + dir;
+
+			if(isBorder)
+				break;
+
+			if(!gs->map->isInTheMap(neighbour))
+				continue;
+
+			for(EPathfindingLayer layer = EPathfindingLayer::LAND; layer < EPathfindingLayer::NUM_LAYERS; layer.advance(1))
+			{
+				const CGPathNode * neighbourNode = getNode(neighbour, layer);
+
+				if(neighbourNode && states[neighbourNode - firstNode] == ENodeState::INVALID)
+				{
+					isBorder = true;
+					break;
+				}
+			}
+		}
+
+		if(isBorder)
+			repairSeeds.push_back(node);
+	}
+
+	logGlobal->trace("Paths of %s repaired, %d nodes are expanded again", out.hero->getNameTranslated(), repairSeeds.size());
+}
+
 void NodeStorage::calculateNeighbours(
 	std::vector<CGPathNode *> & result,
 	const PathNodeInfo & source,
@@ -70,7 +347,10 @@ void NodeStorage::calculateNeighbours(
 	NeighbourTilesVector accessibleNeighbourTiles;
 	
 	result.clear();
-	
+
+	if(!out.hasLayer(layer))
+		return;
+
 	pathfinderHelper->calculateNeighbourTiles(accessibleNeighbourTiles, source);
 
 	for(auto & neighbour : accessibleNeighbourTiles)
@@ -130,6 +410,8 @@ std::vector<CGPathNode *> NodeStorage::getInitialNodes()
 
 	initialNode->turns = 0;
 	initialNode->moveRemains = out.hero->movementPointsRemaining();
+	initialNode->theNodeBefore = nullptr;
+	initialNode->action = EPathNodeAction::UNKNOWN;
 	initialNode->setCost(0.0);
 
 	if(!initialNode->coord.valid())
@@ -137,7 +419,9 @@ std::vector<CGPathNode *> NodeStorage::getInitialNodes()
 		initialNode->coord = out.hpos;
 	}
 
-	return std::vector<CGPathNode *> { initialNode };
+	std::vector<CGPathNode *> initialNodes = { initialNode };
+	vstd::concatenate(initialNodes, repairSeeds);
+	return initialNodes;
 }
 
 void NodeStorage::commit(CDestinationNodeInfo & destination, const PathNodeInfo & source)
@@ -18,10 +18,21 @@ class DLL_LINKAGE NodeStorage : public INodeStorage
 {
 private:
 	CPathsInfo & out;
+	std::vector<CGPathNode *> repairSeeds; // nodes with valid paths that must be expanded again after paths repair
 
 	STRONG_INLINE
 	void resetTile(const int3 & tile, const EPathfindingLayer & layer, EPathAccessibility accessibility);
 
+	template<typename TileHandler, typename NodeHandler>
+	void forEachNode(const CGameState * gs, const TileHandler & tileHandler, const NodeHandler & nodeHandler);
+
+	/// Full recalculation, all nodes are reset
+	void resetGraph(const CGameState * gs);
+
+	/// Keeps paths from previous search that are not affected by hero movement or changes on map
+	/// Root must be node from previous search that hero has reached in current turn without spending more movement points than predicted
+	void repairGraph(const CGameState * gs, CGPathNode * root);
+
 public:
 	NodeStorage(CPathsInfo & pathsInfo, const CGHeroInstance * hero);
 
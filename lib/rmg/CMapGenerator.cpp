@@ -29,7 +29,7 @@
 #include "Zone.h"
 #include "Functions.h"
 #include "RmgMap.h"
-#include "threadpool/ThreadPool.h"
+#include "threadpool/WorkStealingPool.h"
 #include "modificators/ObjectManager.h"
 #include "modificators/TreasurePlacer.h"
 #include "modificators/RoadPlacer.h"
@@ -358,68 +358,71 @@ void CMapGenerator::fillZones()
 
 	Load::Progress::setupStepsTill(allJobs.size(), 240);
 
+	std::vector<Modificator *> readyJobs;
+	for (auto & job : allJobs)
+	{
+		if (job->linkPreceeders())
+			readyJobs.push_back(job.get());
+	}
+
+	const auto startTime = std::chrono::steady_clock::now();
+
 	if (config.singleThread) //No thread pool, just queue with deterministic order
 	{
-		while (!allJobs.empty())
+		//Always run first ready job in order of the list
+		std::vector<Modificator *> jobs;
+		std::map<Modificator *, size_t> jobIndices;
+		for (auto & job : allJobs)
 		{
-			for (auto it = allJobs.begin(); it != allJobs.end();)
-			{
-				if ((*it)->isReady())
-				{
-					auto jobCopy = *it;
-					jobCopy->run();
-					Progress::Progress::step(); //Update progress bar
-					allJobs.erase(it);
-					break; //Restart from the first job
-				}
-				else
-				{
-					++it;
-				}
-			}
+			jobIndices[job.get()] = jobs.size();
+			jobs.push_back(job.get());
+		}
+
+		std::set<size_t> queue;
+		for (auto * job : readyJobs)
+			queue.insert(jobIndices.at(job));
+
+		while (!queue.empty())
+		{
+			auto * job = jobs[*queue.begin()];
+			queue.erase(queue.begin());
+
+			job->run();
+			Progress::Progress::step(); //Update progress bar
+
+			for (auto * successor : job->releaseSuccessors())
+				queue.insert(jobIndices.at(successor));
 		}
 	}
 	else
 	{
-		ThreadPool pool;
-		std::vector<boost::future<void>> futures;
 		//At most one Modificator can run for every zone
-		pool.init(std::min<int>(boost::thread::hardware_concurrency(), numZones));
+		WorkStealingPool pool(std::min<int>(boost::thread::hardware_concurrency(), numZones));
 
-		while (!allJobs.empty())
+		//Job schedules its successors as soon as they have no unfinished preceeders
+		std::function<void(Modificator *)> runJob = [this, &pool, &runJob](Modificator * job)
 		{
-			for (auto it = allJobs.begin(); it != allJobs.end();)
-			{
-				if ((*it)->isFinished())
-				{
-					it = allJobs.erase(it);
-					Progress::Progress::step();
-				}
-				else if ((*it)->isReady())
-				{
-					auto jobCopy = *it;
-					futures.emplace_back(pool.async([this, jobCopy]() -> void
-						{
-							jobCopy->run();
-							Progress::Progress::step(); //Update progress bar
-						}
-					));
-					it = allJobs.erase(it);
-				}
-				else
-				{
-					++it;
-				}
-			}
-		}
+			job->run();
+			Progress::Progress::step(); //Update progress bar
 
-		//Wait for all the tasks
-		for (auto& fut : futures)
-		{
-			fut.get();
-		}
+			for (auto * successor : job->releaseSuccessors())
+				pool.submit([&runJob, successor](){ runJob(successor); });
+		};
+
+		for (auto * job : readyJobs)
+			pool.submit([&runJob, job](){ runJob(job); });
+
+		pool.wait();
 	}
 
+	for (auto & job : allJobs)
+	{
+		if (!job->isFinished())
+			throw rmgException(boost::str(boost::format("Modificator %s in zone %d was never run, dependencies are circular") % job->getName() % job->getZone().getId()));
+	}
+
+	reportModificatorTimes(allJobs, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+
 	for (const auto& it : map->getZones())
 	{
 		if (it.second->getType() == ETemplateZoneType::TREASURE)
@@ -443,6 +446,31 @@ void CMapGenerator::fillZones()
 	Load::Progress::set(250);
 }
 
+void CMapGenerator::reportModificatorTimes(const TModificators & jobs, int64_t totalTime) const
+{
+	std::vector<const Modificator *> sortedJobs;
+	int64_t processTime = 0;
+	int64_t waitTime = 0;
+
+	for (const auto & job : jobs)
+		sortedJobs.push_back(job.get());
+
+	std::sort(sortedJobs.begin(), sortedJobs.end(), [](const Modificator * a, const Modificator * b)
+	{
+		return a->getProcessTime() > b->getProcessTime();
+	});
+
+	logGlobal->debug("Modificator times (zone, modificator, wall time, wait time):");
+	for (const auto * job : sortedJobs)
+	{
+		logGlobal->debug("%d\t%s\t%d ms\t%d ms", job->getZone().getId(), job->getName(), job->getProcessTime(), job->getWaitTime());
+		processTime += job->getProcessTime();
+		waitTime += job->getWaitTime();
+	}
+
+	logGlobal->info("Modificators finished in %d ms, %d ms spent in processing, %d ms in waiting for free thread", totalTime, processTime, waitTime);
+}
+
 void CMapGenerator::addHeaderInfo()
 {
 	auto& m = map->getMap(this);
@@ -24,6 +24,7 @@ class JsonNode;
 class RmgMap;
 class CMap;
 class Zone;
+class Modificator;
 class CZonePlacer;
 class IGameCallback;
 
@@ -101,6 +102,7 @@ private:
 	void addHeaderInfo();
 	void genZones();
 	void fillZones();
+	void reportModificatorTimes(const std::list<std::shared_ptr<Modificator>> & jobs, int64_t totalTime) const;
 };
 
 VCMI_LIB_NAMESPACE_END
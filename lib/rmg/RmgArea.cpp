@@ -11,6 +11,7 @@
 #include "StdInc.h"
 #include "RmgArea.h"
 #include "CMapGenerator.h"
+#include "Functions.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
 
@@ -32,167 +33,464 @@ void toRelative(Tileset & tiles, const int3 & position)
 	toAbsolute(tiles, -position);
 }
 
-Area::Area(const Area & area): dTiles(area.dTiles), dTotalShiftCache(area.dTotalShiftCache)
+static int wordOf(int x)
 {
+	//rounding towards negative infinity
+	return x >= 0 ? x / 64 : -((-x - 1) / 64) - 1;
 }
 
-Area::Area(Area && area) noexcept: dTiles(std::move(area.dTiles)), dTotalShiftCache(area.dTotalShiftCache)
+static int bitOf(int x)
 {
+	return x - wordOf(x) * 64;
+}
+
+static int popCount(uint64_t word)
+{
+	return static_cast<int>(std::bitset<64>(word).count());
+}
+
+static int lowestBit(uint64_t word)
+{
+	return popCount((word & (~word + 1)) - 1);
+}
+
+bool Area::Bounds::empty() const
+{
+	return wordBegin >= wordEnd || yBegin >= yEnd || zBegin >= zEnd;
+}
+
+int Area::Bounds::words() const
+{
+	return wordEnd - wordBegin;
+}
+
+int Area::Bounds::rows() const
+{
+	return (yEnd - yBegin) * (zEnd - zBegin);
+}
+
+size_t Area::Bounds::size() const
+{
+	return empty() ? 0 : static_cast<size_t>(words()) * rows();
+}
+
+size_t Area::Bounds::rowIndex(int y, int z) const
+{
+	return static_cast<size_t>((z - zBegin) * (yEnd - yBegin) + (y - yBegin)) * words();
+}
+
+Area::Bounds Area::Bounds::unite(const Bounds & other) const
+{
+	if(empty())
+		return other;
+	if(other.empty())
+		return *this;
+
+	Bounds result;
+	result.wordBegin = std::min(wordBegin, other.wordBegin);
+	result.wordEnd = std::max(wordEnd, other.wordEnd);
+	result.yBegin = std::min(yBegin, other.yBegin);
+	result.yEnd = std::max(yEnd, other.yEnd);
+	result.zBegin = std::min(zBegin, other.zBegin);
+	result.zEnd = std::max(zEnd, other.zEnd);
+	return result;
+}
+
+Area::Bounds Area::Bounds::intersect(const Bounds & other) const
+{
+	Bounds result;
+	result.wordBegin = std::max(wordBegin, other.wordBegin);
+	result.wordEnd = std::min(wordEnd, other.wordEnd);
+	result.yBegin = std::max(yBegin, other.yBegin);
+	result.yEnd = std::min(yEnd, other.yEnd);
+	result.zBegin = std::max(zBegin, other.zBegin);
+	result.zEnd = std::min(zEnd, other.zEnd);
+
+	if(result.empty())
+		return Bounds();
+	return result;
+}
+
+Area::Area(const Area & area): dBounds(area.dBounds), dBits(area.dBits), dCountCache(area.dCountCache)
+{
+}
+
+Area::Area(Area && area) noexcept: dBounds(area.dBounds), dBits(std::move(area.dBits)), dCountCache(area.dCountCache)
+{
+	area.dBounds = Bounds();
+	area.dBits.clear();
+	area.invalidate();
+	area.dCountCache = 0;
 }
 
 Area & Area::operator=(const Area & area)
 {
-	clear();
-	dTiles = area.dTiles;
-	dTotalShiftCache = area.dTotalShiftCache;
+	if(this == &area)
+		return *this;
+
+	invalidate();
+	dBounds = area.dBounds;
+	dBits = area.dBits;
+	dCountCache = area.dCountCache;
 	return *this;
 }
 
-Area::Area(Tileset tiles): dTiles(std::move(tiles))
+Area::Area(Tileset tiles)
 {
+	assign(std::move(tiles));
 }
 
-Area::Area(Tileset relative, const int3 & position): dTiles(std::move(relative)), dTotalShiftCache(position)
+Area::Area(Tileset relative, const int3 & position)
 {
+	toAbsolute(relative, position);
+	assign(std::move(relative));
 }
 
 void Area::invalidate()
 {
-	getTiles();
 	dTilesVectorCache.clear();
+	dTilesCache.clear();
 	dBorderCache.clear();
 	dBorderOutsideCache.clear();
+	dTilesVectorCacheValid = false;
+	dTilesCacheValid = false;
+	dBorderCacheValid = false;
+	dBorderOutsideCacheValid = false;
+	dCountCache = -1;
 }
 
-bool Area::connected(bool noDiagonals) const
+int Area::tilesCount() const
 {
-	std::list<int3> queue({*dTiles.begin()});
-	Tileset connected = dTiles; //use invalidated cache - ok
+	if(dCountCache < 0)
+	{
+		dCountCache = 0;
+		for(auto word : dBits)
+			dCountCache += popCount(word);
+	}
+	return dCountCache;
+}
 
-	while(!queue.empty())
+int3 Area::firstTile() const
+{
+	for(int z = dBounds.zBegin; z < dBounds.zEnd; ++z)
 	{
-		auto t = queue.front();
-		connected.erase(t);
-		queue.pop_front();
-		
-		if (noDiagonals)
+		for(int y = dBounds.yBegin; y < dBounds.yEnd; ++y)
 		{
-			for (auto& i : dirs4)
+			const size_t row = dBounds.rowIndex(y, z);
+			for(int i = 0; i < dBounds.words(); ++i)
 			{
-				if (connected.count(t + i))
-				{
-					queue.push_back(t + i);
-				}
+				if(dBits[row + i])
+					return int3((dBounds.wordBegin + i) * WORD_BITS + lowestBit(dBits[row + i]), y, z);
 			}
 		}
-		else
+	}
+
+	throw rmgException("Can't get tile of empty area");
+}
+
+Area::TWord Area::wordAt(int word, int y, int z) const
+{
+	if(word < dBounds.wordBegin || word >= dBounds.wordEnd || y < dBounds.yBegin || y >= dBounds.yEnd || z < dBounds.zBegin || z >= dBounds.zEnd)
+		return 0;
+
+	return dBits[dBounds.rowIndex(y, z) + (word - dBounds.wordBegin)];
+}
+
+void Area::setBounds(const Bounds & bounds)
+{
+	const Bounds common = dBounds.intersect(bounds);
+	std::vector<TWord> bits(bounds.size(), 0);
+
+	for(int z = common.zBegin; z < common.zEnd; ++z)
+	{
+		for(int y = common.yBegin; y < common.yEnd; ++y)
 		{
-			for (auto& i : int3::getDirs())
+			std::copy_n(dBits.begin() + dBounds.rowIndex(y, z) + (common.wordBegin - dBounds.wordBegin), common.words(),
+				bits.begin() + bounds.rowIndex(y, z) + (common.wordBegin - bounds.wordBegin));
+		}
+	}
+
+	//tiles outside of new bounds are lost
+	if(common.size() != dBounds.size())
+		dCountCache = -1;
+
+	dBounds = bounds.empty() ? Bounds() : bounds;
+	dBits.swap(bits);
+}
+
+void Area::reserve(const Bounds & bounds)
+{
+	Bounds target = dBounds.unite(bounds);
+
+	if(target.size() == dBounds.size())
+		return;
+
+	if(!dBounds.empty())
+	{
+		//grow in direction of new tiles by half of current size
+		const int wordsSpare = dBounds.words() / 2;
+		const int rowsSpare = (dBounds.yEnd - dBounds.yBegin) / 2;
+
+		if(target.wordBegin < dBounds.wordBegin)
+			target.wordBegin -= wordsSpare;
+		if(target.wordEnd > dBounds.wordEnd)
+			target.wordEnd += wordsSpare;
+		if(target.yBegin < dBounds.yBegin)
+			target.yBegin -= rowsSpare;
+		if(target.yEnd > dBounds.yEnd)
+			target.yEnd += rowsSpare;
+	}
+
+	setBounds(target);
+}
+
+void Area::shrinkToFit()
+{
+	Bounds tight;
+	bool first = true;
+
+	for(int z = dBounds.zBegin; z < dBounds.zEnd; ++z)
+	{
+		for(int y = dBounds.yBegin; y < dBounds.yEnd; ++y)
+		{
+			const size_t row = dBounds.rowIndex(y, z);
+			for(int i = 0; i < dBounds.words(); ++i)
 			{
-				if (connected.count(t + i))
+				if(!dBits[row + i])
+					continue;
+
+				const int word = dBounds.wordBegin + i;
+				if(first)
+				{
+					tight = {word, word + 1, y, y + 1, z, z + 1};
+					first = false;
+				}
+				else
 				{
-					queue.push_back(t + i);
+					tight = tight.unite({word, word + 1, y, y + 1, z, z + 1});
 				}
 			}
 		}
 	}
-	
-	return connected.empty();
+
+	if(tight.size() != dBounds.size())
+		setBounds(tight);
 }
 
-std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections)
+template<typename Func>
+void Area::forEachTile(const Func & func) const
 {
-	auto allDirs = int3::getDirs();
-	std::vector<int3> dirs(allDirs.begin(), allDirs.end());
-	if(disableDiagonalConnections)
-		dirs.assign(rmg::dirs4.begin(), rmg::dirs4.end());
-	
-	std::list<Area> result;
-	Tileset connected = area.getTiles();
-	while(!connected.empty())
+	for(int z = dBounds.zBegin; z < dBounds.zEnd; ++z)
+	{
+		for(int y = dBounds.yBegin; y < dBounds.yEnd; ++y)
+		{
+			const size_t row = dBounds.rowIndex(y, z);
+			for(int i = 0; i < dBounds.words(); ++i)
+			{
+				for(TWord word = dBits[row + i]; word; word &= word - 1)
+					func(int3((dBounds.wordBegin + i) * WORD_BITS + lowestBit(word), y, z));
+			}
+		}
+	}
+}
+
+Area Area::dilated(bool diagonals) const
+{
+	Area result;
+
+	if(dBounds.empty())
+		return result;
+
+	Bounds bounds = dBounds;
+	bounds.wordBegin--;
+	bounds.wordEnd++;
+	bounds.yBegin--;
+	bounds.yEnd++;
+	result.setBounds(bounds);
+
+	//tile and its horizontal neighbours
+	auto rowDilated = [this](int word, int y, int z) -> TWord
+	{
+		const TWord center = wordAt(word, y, z);
+		return center | (center << 1) | (wordAt(word - 1, y, z) >> (WORD_BITS - 1)) | (center >> 1) | (wordAt(word + 1, y, z) << (WORD_BITS - 1));
+	};
+
+	for(int z = bounds.zBegin; z < bounds.zEnd; ++z)
 	{
-		result.emplace_back();
-		std::list<int3> queue({*connected.begin()});
-		std::set<int3> queueSet({*connected.begin()});
-		while(!queue.empty())
+		for(int y = bounds.yBegin; y < bounds.yEnd; ++y)
 		{
-			auto t = queue.front();
-			connected.erase(t);
-			result.back().add(t);
-			queue.pop_front();
-			
-			for(auto & i : dirs)
+			const size_t row = bounds.rowIndex(y, z);
+			for(int word = bounds.wordBegin; word < bounds.wordEnd; ++word)
 			{
-				auto tile = t + i;
-				if(!queueSet.count(tile) && connected.count(tile) && !result.back().contains(tile))
+				TWord value = rowDilated(word, y, z);
+
+				if(diagonals)
+					value |= rowDilated(word, y - 1, z) | rowDilated(word, y + 1, z);
+				else
+					value |= wordAt(word, y - 1, z) | wordAt(word, y + 1, z);
+
+				result.dBits[row + (word - bounds.wordBegin)] = value;
+			}
+		}
+	}
+
+	result.dCountCache = -1;
+	result.shrinkToFit();
+	return result;
+}
+
+Area Area::eroded() const
+{
+	Area result;
+	result.setBounds(dBounds);
+
+	//tiles which have both horizontal neighbours
+	auto rowEroded = [this](int word, int y, int z) -> TWord
+	{
+		const TWord center = wordAt(word, y, z);
+		return center & ((center << 1) | (wordAt(word - 1, y, z) >> (WORD_BITS - 1))) & ((center >> 1) | (wordAt(word + 1, y, z) << (WORD_BITS - 1)));
+	};
+
+	for(int z = dBounds.zBegin; z < dBounds.zEnd; ++z)
+	{
+		for(int y = dBounds.yBegin; y < dBounds.yEnd; ++y)
+		{
+			const size_t row = dBounds.rowIndex(y, z);
+			for(int word = dBounds.wordBegin; word < dBounds.wordEnd; ++word)
+				result.dBits[row + (word - dBounds.wordBegin)] = rowEroded(word, y - 1, z) & rowEroded(word, y, z) & rowEroded(word, y + 1, z);
+		}
+	}
+
+	result.dCountCache = -1;
+	result.shrinkToFit();
+	return result;
+}
+
+Area Area::floodFill(const int3 & start, bool diagonals) const
+{
+	Area result;
+	result.setBounds(dBounds);
+
+	const int startWord = wordOf(start.x);
+	result.dBits[dBounds.rowIndex(start.y, start.z) + (startWord - dBounds.wordBegin)] = TWord(1) << bitOf(start.x);
+
+	//fill is updated in place, so changes propagate within single pass. Only rows and words next to already filled part are checked
+	Bounds active = {startWord, startWord + 1, start.y, start.y + 1, start.z, start.z + 1};
+	bool changed = true;
+
+	while(changed)
+	{
+		changed = false;
+		const Bounds checked = dBounds.intersect({active.wordBegin - 1, active.wordEnd + 1, active.yBegin - 1, active.yEnd + 1, active.zBegin, active.zEnd});
+
+		for(int y = checked.yBegin; y < checked.yEnd; ++y)
+		{
+			const size_t row = dBounds.rowIndex(y, start.z);
+			for(int word = checked.wordBegin; word < checked.wordEnd; ++word)
+			{
+				const TWord center = result.wordAt(word, y, start.z);
+				TWord value = center | (center << 1) | (result.wordAt(word - 1, y, start.z) >> (WORD_BITS - 1)) | (center >> 1) | (result.wordAt(word + 1, y, start.z) << (WORD_BITS - 1));
+
+				for(int dy : {-1, 1})
+				{
+					const TWord vertical = result.wordAt(word, y + dy, start.z);
+					value |= vertical;
+
+					if(diagonals)
+						value |= (vertical << 1) | (result.wordAt(word - 1, y + dy, start.z) >> (WORD_BITS - 1)) | (vertical >> 1) | (result.wordAt(word + 1, y + dy, start.z) << (WORD_BITS - 1));
+				}
+
+				value &= dBits[row + (word - dBounds.wordBegin)];
+
+				if(value != center)
 				{
-					queueSet.insert(tile);
-					queue.push_back(tile);
+					result.dBits[row + (word - dBounds.wordBegin)] = value;
+					active = active.unite({word, word + 1, y, y + 1, start.z, start.z + 1});
+					changed = true;
 				}
 			}
 		}
 	}
+
+	result.dCountCache = -1;
+	result.shrinkToFit();
+	return result;
+}
+
+bool Area::connected(bool noDiagonals) const
+{
+	if(empty())
+		return true;
+
+	return floodFill(firstTile(), !noDiagonals).tilesCount() == tilesCount();
+}
+
+std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections)
+{
+	std::list<Area> result;
+	Area remaining(area);
+
+	while(!remaining.empty())
+	{
+		result.push_back(remaining.floodFill(remaining.firstTile(), !disableDiagonalConnections));
+		remaining.subtract(result.back());
+		remaining.shrinkToFit();
+	}
 	return result;
 }
 
 const Tileset & Area::getTiles() const
 {
-	if(dTotalShiftCache != int3())
+	if(!dTilesCacheValid)
 	{
-		toAbsolute(dTiles, dTotalShiftCache);
-		dTotalShiftCache = int3();
+		const auto & tiles = getTilesVector();
+		dTilesCache = Tileset(tiles.begin(), tiles.end());
+		dTilesCacheValid = true;
 	}
-	return dTiles;
+	return dTilesCache;
 }
 
 const std::vector<int3> & Area::getTilesVector() const
 {
-	if(dTilesVectorCache.empty())
+	if(!dTilesVectorCacheValid)
 	{
-		getTiles();
-		dTilesVectorCache.assign(dTiles.begin(), dTiles.end());
+		dTilesVectorCache.clear();
+		dTilesVectorCache.reserve(tilesCount());
+		forEachTile([this](const int3 & tile)
+		{
+			dTilesVectorCache.push_back(tile);
+		});
+		dTilesVectorCacheValid = true;
 	}
 	return dTilesVectorCache;
 }
 
 const Tileset & Area::getBorder() const
 {
-	if(!dBorderCache.empty())
+	if(dBorderCacheValid)
 		return dBorderCache;
-	
-	//compute border cache
-	dBorderCache.reserve(dTiles.bucket_count());
-	for(const auto & t : dTiles)
-	{
-		for(auto & i : int3::getDirs())
-		{
-			if(!dTiles.count(t + i))
-			{
-				dBorderCache.insert(t + dTotalShiftCache);
-				break;
-			}
-		}
-	}
-	
+
+	//tiles with at least one neighbour outside of area
+	Area border(*this);
+	border.subtract(eroded());
+
+	const auto & tiles = border.getTilesVector();
+	dBorderCache = Tileset(tiles.begin(), tiles.end());
+	dBorderCacheValid = true;
 	return dBorderCache;
 }
 
 const Tileset & Area::getBorderOutside() const
 {
-	if(!dBorderOutsideCache.empty())
+	if(dBorderOutsideCacheValid)
 		return dBorderOutsideCache;
-	
-	//compute outside border cache
-	dBorderOutsideCache.reserve(dBorderCache.bucket_count() * 2);
-	for(const auto & t : dTiles)
-	{
-		for(auto & i : int3::getDirs())
-		{
-			if(!dTiles.count(t + i))
-				dBorderOutsideCache.insert(t + i + dTotalShiftCache);
-		}
-	}
-	
+
+	Area borderOutside = dilated(true);
+	borderOutside.subtract(*this);
+
+	const auto & tiles = borderOutside.getTilesVector();
+	dBorderOutsideCache = Tileset(tiles.begin(), tiles.end());
+	dBorderOutsideCacheValid = true;
 	return dBorderOutsideCache;
 }
 
@@ -202,25 +500,30 @@ DistanceMap Area::computeDistanceMap(std::map<int, Tileset> & reverseDistanceMap
 	DistanceMap result;
 	auto area = *this;
 	int distance = 0;
-	
+
 	while(!area.empty())
 	{
-		for(const auto & tile : area.getBorder())
+		Area inner = area.eroded();
+		area.subtract(inner);
+
+		const auto & border = area.getTilesVector();
+		for(const auto & tile : border)
 			result[tile] = distance;
-		reverseDistanceMap[distance++] = area.getBorder();
-		area.subtract(area.getBorder());
+		reverseDistanceMap[distance++] = Tileset(border.begin(), border.end());
+
+		area = std::move(inner);
 	}
 	return result;
 }
 
 bool Area::empty() const
 {
-	return dTiles.empty();
+	return tilesCount() == 0;
 }
 
 bool Area::contains(const int3 & tile) const
 {
-	return dTiles.count(tile - dTotalShiftCache);
+	return (wordAt(wordOf(tile.x), tile.y, tile.z) >> bitOf(tile.x)) & 1;
 }
 
 bool Area::contains(const std::vector<int3> & tiles) const
@@ -235,12 +538,25 @@ bool Area::contains(const std::vector<int3> & tiles) const
 
 bool Area::contains(const Area & area) const
 {
-	return contains(area.getTilesVector());
+	const Bounds & bounds = area.dBounds;
+
+	for(int z = bounds.zBegin; z < bounds.zEnd; ++z)
+	{
+		for(int y = bounds.yBegin; y < bounds.yEnd; ++y)
+		{
+			const size_t row = bounds.rowIndex(y, z);
+			for(int word = bounds.wordBegin; word < bounds.wordEnd; ++word)
+			{
+				if(area.dBits[row + (word - bounds.wordBegin)] & ~wordAt(word, y, z))
+					return false;
+			}
+		}
+	}
+	return true;
 }
 
 bool Area::overlap(const std::vector<int3> & tiles) const
 {
-	// Important: Make sure that tiles.size < area.size
 	for(const auto & t : tiles)
 	{
 		if(contains(t))
@@ -251,7 +567,20 @@ bool Area::overlap(const std::vector<int3> & tiles) const
 
 bool Area::overlap(const Area & area) const
 {
-	return overlap(area.getTilesVector());
+	const Bounds common = dBounds.intersect(area.dBounds);
+
+	for(int z = common.zBegin; z < common.zEnd; ++z)
+	{
+		for(int y = common.yBegin; y < common.yEnd; ++y)
+		{
+			for(int word = common.wordBegin; word < common.wordEnd; ++word)
+			{
+				if(wordAt(word, y, z) & area.wordAt(word, y, z))
+					return true;
+			}
+		}
+	}
+	return false;
 }
 
 int Area::distance(const int3 & tile) const
@@ -303,90 +632,197 @@ int3 Area::nearest(const Area & area) const
 
 Area Area::getSubarea(const std::function<bool(const int3 &)> & filter) const
 {
-	Area subset;
-	subset.dTiles.reserve(getTilesVector().size());
-	vstd::copy_if(getTilesVector(), vstd::set_inserter(subset.dTiles), filter);
+	Area subset(*this);
+	subset.erase_if([&filter](const int3 & tile)
+	{
+		return !filter(tile);
+	});
 	return subset;
 }
 
 void Area::clear()
 {
-	dTiles.clear();
-	dTilesVectorCache.clear();
-	dTotalShiftCache = int3();
 	invalidate();
+	dBounds = Bounds();
+	dBits.clear();
+	dCountCache = 0;
 }
 
 void Area::assign(const Tileset tiles)
 {
 	clear();
-	dTiles = tiles;
+
+	if(tiles.empty())
+		return;
+
+	Bounds bounds;
+	for(const auto & tile : tiles)
+	{
+		const int word = wordOf(tile.x);
+		bounds = bounds.unite({word, word + 1, tile.y, tile.y + 1, tile.z, tile.z + 1});
+	}
+	setBounds(bounds);
+
+	for(const auto & tile : tiles)
+		dBits[dBounds.rowIndex(tile.y, tile.z) + (wordOf(tile.x) - dBounds.wordBegin)] |= TWord(1) << bitOf(tile.x);
+
+	dCountCache = static_cast<int>(tiles.size());
 }
 
 void Area::add(const int3 & tile)
 {
+	if(contains(tile))
+		return;
+
+	const int count = dCountCache;
+	const int word = wordOf(tile.x);
+
 	invalidate();
-	dTiles.insert(tile);
+	reserve({word, word + 1, tile.y, tile.y + 1, tile.z, tile.z + 1});
+	dBits[dBounds.rowIndex(tile.y, tile.z) + (word - dBounds.wordBegin)] |= TWord(1) << bitOf(tile.x);
+	dCountCache = count < 0 ? -1 : count + 1;
 }
 
 void Area::erase(const int3 & tile)
 {
+	if(!contains(tile))
+		return;
+
+	const int count = dCountCache;
+
 	invalidate();
-	dTiles.erase(tile);
+	dBits[dBounds.rowIndex(tile.y, tile.z) + (wordOf(tile.x) - dBounds.wordBegin)] &= ~(TWord(1) << bitOf(tile.x));
+	dCountCache = count < 0 ? -1 : count - 1;
 }
+
 void Area::unite(const Area & area)
 {
+	if(area.dBounds.empty())
+		return;
+
 	invalidate();
-	const auto & vec = area.getTilesVector();
-	dTiles.reserve(dTiles.size() + vec.size());
-	dTiles.insert(vec.begin(), vec.end());
+	setBounds(dBounds.unite(area.dBounds));
+
+	const Bounds & bounds = area.dBounds;
+	for(int z = bounds.zBegin; z < bounds.zEnd; ++z)
+	{
+		for(int y = bounds.yBegin; y < bounds.yEnd; ++y)
+		{
+			const TWord * src = area.dBits.data() + bounds.rowIndex(y, z);
+			TWord * dst = dBits.data() + dBounds.rowIndex(y, z) + (bounds.wordBegin - dBounds.wordBegin);
+
+			for(int i = 0; i < bounds.words(); ++i)
+				dst[i] |= src[i];
+		}
+	}
+	dCountCache = -1;
 }
 
 void Area::intersect(const Area & area)
 {
 	invalidate();
-	Tileset result;
-	result.reserve(std::max(dTiles.size(), area.getTilesVector().size()));
-	for(const auto & t : area.getTilesVector())
+	setBounds(dBounds.intersect(area.dBounds));
+
+	for(int z = dBounds.zBegin; z < dBounds.zEnd; ++z)
 	{
-		if(dTiles.count(t))
-			result.insert(t);
+		for(int y = dBounds.yBegin; y < dBounds.yEnd; ++y)
+		{
+			const TWord * src = area.dBits.data() + area.dBounds.rowIndex(y, z) + (dBounds.wordBegin - area.dBounds.wordBegin);
+			TWord * dst = dBits.data() + dBounds.rowIndex(y, z);
+
+			for(int i = 0; i < dBounds.words(); ++i)
+				dst[i] &= src[i];
+		}
 	}
-	dTiles = result;
+	dCountCache = -1;
+	shrinkToFit();
 }
 
 void Area::subtract(const Area & area)
 {
 	invalidate();
-	for(const auto & t : area.getTilesVector())
+	const Bounds common = dBounds.intersect(area.dBounds);
+
+	for(int z = common.zBegin; z < common.zEnd; ++z)
 	{
-		dTiles.erase(t);
+		for(int y = common.yBegin; y < common.yEnd; ++y)
+		{
+			const TWord * src = area.dBits.data() + area.dBounds.rowIndex(y, z) + (common.wordBegin - area.dBounds.wordBegin);
+			TWord * dst = dBits.data() + dBounds.rowIndex(y, z) + (common.wordBegin - dBounds.wordBegin);
+
+			for(int i = 0; i < common.words(); ++i)
+				dst[i] &= ~src[i];
+		}
 	}
+	dCountCache = -1;
 }
 
 void Area::translate(const int3 & shift)
 {
-	dBorderCache.clear();
-	dBorderOutsideCache.clear();
+	if(shift == int3())
+		return;
 
-	if(dTilesVectorCache.empty())
+	//shifted tiles keep their order, so vector cache is still valid
+	std::vector<int3> tilesVector = std::move(dTilesVectorCache);
+	const bool tilesVectorValid = dTilesVectorCacheValid;
+	const int count = dCountCache;
+
+	invalidate();
+
+	if(!dBounds.empty())
 	{
-		getTilesVector();
+		const int wordShift = wordOf(shift.x);
+		const int bitShift = bitOf(shift.x);
+
+		Bounds bounds = dBounds;
+		bounds.wordBegin += wordShift;
+		bounds.wordEnd += wordShift + (bitShift ? 1 : 0);
+		bounds.yBegin += shift.y;
+		bounds.yEnd += shift.y;
+		bounds.zBegin += shift.z;
+		bounds.zEnd += shift.z;
+
+		if(bitShift)
+		{
+			std::vector<TWord> bits(bounds.size(), 0);
+			const int words = dBounds.words();
+
+			for(int row = 0; row < dBounds.rows(); ++row)
+			{
+				const TWord * src = dBits.data() + row * words;
+				TWord * dst = bits.data() + row * (words + 1);
+
+				for(int i = 0; i < words; ++i)
+				{
+					dst[i] |= src[i] << bitShift;
+					dst[i + 1] |= src[i] >> (WORD_BITS - bitShift);
+				}
+			}
+			dBits.swap(bits);
+		}
+		dBounds = bounds;
 	}
-	
-	//avoid recomputation within std::set, use vector instead
-	dTotalShiftCache += shift;
-	
-	for(auto & t : dTilesVectorCache)
+
+	if(tilesVectorValid)
 	{
-		t += shift;
+		for(auto & t : tilesVector)
+			t += shift;
+
+		dTilesVectorCache = std::move(tilesVector);
+		dTilesVectorCacheValid = true;
 	}
+	dCountCache = count;
 }
 
 void Area::erase_if(std::function<bool(const int3&)> predicate)
 {
 	invalidate();
-	vstd::erase_if(dTiles, predicate);
+
+	forEachTile([this, &predicate](const int3 & tile)
+	{
+		if(predicate(tile))
+			dBits[dBounds.rowIndex(tile.y, tile.z) + (wordOf(tile.x) - dBounds.wordBegin)] &= ~(TWord(1) << bitOf(tile.x));
+	});
 }
 
 Area operator- (const Area & l, const int3 & r)
@@ -405,12 +841,8 @@ Area operator+ (const Area & l, const int3 & r)
 
 Area operator+ (const Area & l, const Area & r)
 {
-	Area result;
-	const auto & lTiles = l.getTilesVector();
-	const auto & rTiles = r.getTilesVector();
-	result.dTiles.reserve(lTiles.size() + rTiles.size());
-	result.dTiles.insert(lTiles.begin(), lTiles.end());
-	result.dTiles.insert(rTiles.begin(), rTiles.end());
+	Area result(l);
+	result.unite(r);
 	return result;
 }
 
@@ -76,16 +76,59 @@ namespace rmg
 		friend std::list<Area> connectedAreas(const Area & area, bool disableDiagonalConnections);
 		
 	private:
-		
+		/// Area is stored as bitmap covering its bounding box, split into rows of 64-bit words along X axis
+		/// Word N always covers X in range [64 * N, 64 * N + 63], so two areas can be combined word by word without any shifts
+		using TWord = uint64_t;
+		static constexpr int WORD_BITS = 64;
+
+		struct Bounds
+		{
+			int wordBegin = 0; //first word on X axis
+			int wordEnd = 0;
+			int yBegin = 0;
+			int yEnd = 0;
+			int zBegin = 0;
+			int zEnd = 0;
+
+			bool empty() const;
+			int words() const;
+			int rows() const; //rows on all levels
+			size_t size() const;
+			size_t rowIndex(int y, int z) const;
+			Bounds unite(const Bounds & other) const;
+			Bounds intersect(const Bounds & other) const;
+		};
+
+		Bounds dBounds;
+		std::vector<TWord> dBits; //[z][y][word]
+
 		void invalidate();
-		void computeBorderCache();
-		void computeBorderOutsideCache();
-		
-		mutable Tileset dTiles;
+		int tilesCount() const;
+		int3 firstTile() const;
+		void reserve(const Bounds & bounds); //extends bounds with spare space to make adding tiles one by one cheap
+		void setBounds(const Bounds & bounds); //keeps tiles that are inside new bounds
+		void shrinkToFit();
+		TWord wordAt(int word, int y, int z) const; //0 outside of bounds
+
+		template<typename Func>
+		void forEachTile(const Func & func) const;
+
+		/// Tiles with 8 (or 4) neighbours added, computed on area bounds extended by 1 tile
+		Area dilated(bool diagonals) const;
+		/// Tiles that have all 8 neighbours inside area
+		Area eroded() const;
+		/// Part of area connected to given tile, which must belong to area
+		Area floodFill(const int3 & start, bool diagonals) const;
+
 		mutable std::vector<int3> dTilesVectorCache;
+		mutable Tileset dTilesCache;
 		mutable Tileset dBorderCache;
 		mutable Tileset dBorderOutsideCache;
-		mutable int3 dTotalShiftCache;
+		mutable bool dTilesVectorCacheValid = false;
+		mutable bool dTilesCacheValid = false;
+		mutable bool dBorderCacheValid = false;
+		mutable bool dBorderOutsideCacheValid = false;
+		mutable int dCountCache = 0; //-1 if not known
 	};
 }
 
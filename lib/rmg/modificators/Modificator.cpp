@@ -13,7 +13,6 @@
 #include "../Functions.h"
 #include "../CMapGenerator.h"
 #include "../RmgMap.h"
-#include "../../CStopWatch.h"
 #include "../../mapping/CMap.h"
 
 VCMI_LIB_NAMESPACE_BEGIN
@@ -33,45 +32,52 @@ const std::string & Modificator::getName() const
 	return name;
 }
 
-bool Modificator::isReady()
+const Zone & Modificator::getZone() const
 {
-	Lock lock(mx, boost::try_to_lock);
-	if (!lock.owns_lock())
-	{
-		return false;
-	}
-	else
+	return zone;
+}
+
+bool Modificator::linkPreceeders()
+{
+	for(auto * preceeder : preceeders)
+		preceeder->successors.push_back(this);
+
+	unfinishedPreceeders = preceeders.size();
+	readyTime = Clock::now();
+	return preceeders.empty();
+}
+
+std::vector<Modificator *> Modificator::releaseSuccessors()
+{
+	std::vector<Modificator *> ready;
+
+	for(auto * successor : successors)
 	{
-		//Check prerequisites
-		for (auto it = preceeders.begin(); it != preceeders.end();)
+		//Last finished preceeder makes successor ready
+		if(--successor->unfinishedPreceeders == 0)
 		{
-			if ((*it)->isFinished()) //OK
-			{
-				//This preceeder won't be checked in the future
-				it = preceeders.erase(it);
-			}
-			else
-			{
-				return false;
-			}
+			successor->readyTime = Clock::now();
+			ready.push_back(successor);
 		}
-
-		//If a job is finished, it should be already erased from a queue
-		return !finished;
 	}
+
+	return ready;
 }
 
-bool Modificator::isFinished()
+bool Modificator::isFinished() const
 {
-	Lock lock(mx, boost::try_to_lock);
-	if (!lock.owns_lock())
-	{
-		return false;
-	}
-	else
-	{
-		return finished;
-	}
+	Lock lock(mx);
+	return finished;
+}
+
+int64_t Modificator::getWaitTime() const
+{
+	return waitTime;
+}
+
+int64_t Modificator::getProcessTime() const
+{
+	return processTime;
 }
 
 void Modificator::run()
@@ -81,7 +87,8 @@ void Modificator::run()
 	if(!finished)
 	{
 		logGlobal->trace("Modificator zone %d - %s - started", zone.getId(), getName());
-		CStopWatch processTime;
+		const auto startTime = Clock::now();
+		waitTime = std::chrono::duration_cast<std::chrono::milliseconds>(startTime - readyTime).count();
 		try
 		{
 			process();
@@ -94,7 +101,8 @@ void Modificator::run()
 		dump();
 #endif
 		finished = true;
-		logGlobal->trace("Modificator zone %d - %s - done (%d ms)", zone.getId(), getName(), processTime.getDiff());
+		processTime = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - startTime).count();
+		logGlobal->trace("Modificator zone %d - %s - done (%d ms)", zone.getId(), getName(), processTime);
 	}
 }
 
@@ -46,14 +46,23 @@ public:
 
 	void setName(const std::string & n);
 	const std::string & getName() const;
+	const Zone & getZone() const;
+
+	/// Registers modificator as successor of all its preceeders, returns true if it has no preceeders and can run immediately
+	bool linkPreceeders();
+	/// Must be called after run, returns successors which have no more unfinished preceeders
+	std::vector<Modificator *> releaseSuccessors();
+	bool isFinished() const;
 
-	bool isReady();
-	bool isFinished();
-	
 	void run();
 	void dependency(Modificator * modificator);
 	void postfunction(Modificator * modificator);
 
+	/// Time between moment all preceeders were finished and start of processing, in milliseconds
+	int64_t getWaitTime() const;
+	/// Time spent in processing, in milliseconds
+	int64_t getProcessTime() const;
+
 protected:
 	RmgMap & map;
 	std::shared_ptr<MapProxy> mapProxy;
@@ -72,6 +81,13 @@ private:
 	std::string name;
 
 	std::list<Modificator*> preceeders; //must be ordered container
+	std::vector<Modificator*> successors;
+	std::atomic<int> unfinishedPreceeders{0};
+
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point readyTime;
+	int64_t waitTime = 0;
+	int64_t processTime = 0;
 
 	mutable boost::shared_mutex mx; //Used only for task scheduling
 
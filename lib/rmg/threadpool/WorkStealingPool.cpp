@@ -0,0 +1,152 @@
+/*
+ * WorkStealingPool.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "WorkStealingPool.h"
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Pool and queue index of worker running on current thread, used to submit tasks into own queue
+static thread_local std::pair<const WorkStealingPool *, size_t> currentWorker(nullptr, 0);
+
+WorkStealingPool::WorkStealingPool(size_t numThreads)
+{
+	numThreads = std::max<size_t>(numThreads, 1);
+
+	for(size_t i = 0; i < numThreads; ++i)
+		queues.push_back(std::make_unique<WorkerQueue>());
+
+	workers.reserve(numThreads);
+	for(size_t i = 0; i < numThreads; ++i)
+		workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		Lock lock(mx);
+		stopping = true;
+	}
+	taskAdded.notify_all();
+
+	for(auto & worker : workers)
+		worker.join();
+}
+
+size_t WorkStealingPool::size() const
+{
+	return workers.size();
+}
+
+void WorkStealingPool::submit(TTask task)
+{
+	size_t index = currentWorker.second;
+
+	{
+		// counters are updated first so task can not be finished before it was counted
+		Lock lock(mx);
+		++queuedTasks;
+		++unfinishedTasks;
+
+		if(currentWorker.first != this)
+		{
+			index = nextQueue;
+			nextQueue = (nextQueue + 1) % queues.size();
+		}
+	}
+
+	{
+		Lock lock(queues[index]->mx);
+		queues[index]->tasks.push_back(std::move(task));
+	}
+
+	taskAdded.notify_one();
+}
+
+void WorkStealingPool::wait()
+{
+	Lock lock(mx);
+	allFinished.wait(lock, [this](){ return unfinishedTasks == 0; });
+
+	if(error)
+		std::rethrow_exception(std::exchange(error, nullptr));
+}
+
+bool WorkStealingPool::takeTask(size_t index, TTask & task)
+{
+	{
+		WorkerQueue & own = *queues[index];
+		Lock lock(own.mx);
+
+		if(!own.tasks.empty())
+		{
+			task = std::move(own.tasks.back());
+			own.tasks.pop_back();
+			return true;
+		}
+	}
+
+	for(size_t i = 1; i < queues.size(); ++i)
+	{
+		WorkerQueue & victim = *queues[(index + i) % queues.size()];
+		Lock lock(victim.mx);
+
+		if(!victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+			victim.tasks.pop_front();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index)
+{
+	currentWorker = std::make_pair(this, index);
+
+	while(true)
+	{
+		{
+			Lock lock(mx);
+			taskAdded.wait(lock, [this](){ return stopping || queuedTasks > 0; });
+
+			if(stopping && queuedTasks == 0)
+				return;
+		}
+
+		TTask task;
+		if(!takeTask(index, task))
+			continue; //another worker was faster
+
+		{
+			Lock lock(mx);
+			--queuedTasks;
+		}
+
+		try
+		{
+			task();
+		}
+		catch(...)
+		{
+			Lock lock(mx);
+			if(!error)
+				error = std::current_exception();
+		}
+
+		Lock lock(mx);
+		if(--unfinishedTasks == 0)
+			allFinished.notify_all();
+	}
+}
+
+VCMI_LIB_NAMESPACE_END
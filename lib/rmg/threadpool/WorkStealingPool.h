@@ -0,0 +1,62 @@
+/*
+ * WorkStealingPool.h, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#pragma once
+
+#include <boost/thread/condition_variable.hpp>
+
+VCMI_LIB_NAMESPACE_BEGIN
+
+/// Thread pool with separate task queue for each worker
+/// Tasks submitted from a worker go to its own queue and are taken in LIFO order,
+/// idle workers steal the oldest tasks from queues of other workers
+class DLL_LINKAGE WorkStealingPool : boost::noncopyable
+{
+public:
+	using TTask = std::function<void()>;
+
+	explicit WorkStealingPool(size_t numThreads);
+	~WorkStealingPool();
+
+	/// Can be called both from outside of pool and from running tasks
+	void submit(TTask task);
+
+	/// Blocks until all tasks, including ones submitted by other tasks, are finished
+	/// Rethrows first exception thrown by any task
+	void wait();
+
+	size_t size() const;
+
+private:
+	struct WorkerQueue
+	{
+		boost::mutex mx;
+		std::deque<TTask> tasks;
+	};
+
+	using Lock = boost::unique_lock<boost::mutex>;
+
+	std::vector<std::unique_ptr<WorkerQueue>> queues;
+	std::vector<boost::thread> workers;
+
+	boost::mutex mx; //protects all fields below
+	boost::condition_variable taskAdded;
+	boost::condition_variable allFinished;
+	size_t queuedTasks = 0;
+	size_t unfinishedTasks = 0;
+	size_t nextQueue = 0;
+	bool stopping = false;
+	std::exception_ptr error;
+
+	void workerLoop(size_t index);
+	bool takeTask(size_t index, TTask & task);
+};
+
+VCMI_LIB_NAMESPACE_END
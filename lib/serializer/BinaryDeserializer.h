@@ -16,6 +16,8 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+class TerrainChunkCache;
+
 class DLL_LINKAGE CLoaderBase
 {
 protected:
@@ -27,7 +29,13 @@ public:
 	{
 		auto bytePtr = reinterpret_cast<std::byte*>(data);
 
-		reader->read(bytePtr, size);
+		if(reader->bufferEnd - reader->bufferBegin >= static_cast<ptrdiff_t>(size))
+		{
+			std::memcpy(bytePtr, reader->bufferBegin, size);
+			reader->bufferBegin += size;
+		}
+		else
+			reader->read(bytePtr, size);
 		if(reverseEndianness)
 			std::reverse(bytePtr, bytePtr + size);
 	};
@@ -98,9 +106,10 @@ public:
 	Version version;
 
 	std::vector<std::string> loadedStrings;
-	std::map<uint32_t, Serializeable*> loadedPointers;
-	std::map<const Serializeable*, std::shared_ptr<Serializeable>> loadedSharedPointers;
+	std::vector<Serializeable*> loadedPointers; //indexed by pid, which are given sequentially by serializer
+	std::unordered_map<const Serializeable*, std::shared_ptr<Serializeable>> loadedSharedPointers;
 	IGameCallback * cb = nullptr;
+	const TerrainChunkCache * terrainChunkCache = nullptr;
 	static constexpr bool trackSerializedPointers = true;
 	static constexpr bool saving = false;
 	bool loadingGamestate = false;
@@ -131,15 +140,15 @@ public:
 
 			if ((byteValue & 0x80) != 0)
 			{
-				valueUnsigned |= (byteValue & 0x7f) << offset;
+				valueUnsigned |= static_cast<uint64_t>(byteValue & 0x7f) << offset;
 				offset += 7;
 			}
 			else
 			{
-				valueUnsigned |= (byteValue & 0x3f) << offset;
+				valueUnsigned |= static_cast<uint64_t>(byteValue & 0x3f) << offset;
 				bool isNegative = (byteValue & 0x40) != 0;
 				if (isNegative)
-					return -static_cast<int64_t>(valueUnsigned);
+					return static_cast<int64_t>(0 - valueUnsigned);
 				else
 					return valueUnsigned;
 			}
@@ -282,13 +291,12 @@ public:
 		if(trackSerializedPointers)
 		{
 			load( pid ); //get the id
-			auto i = loadedPointers.find(pid); //lookup
 
-			if(i != loadedPointers.end())
+			if(pid < loadedPointers.size() && loadedPointers[pid] != nullptr)
 			{
 				// We already got this pointer
 				// Cast it in case we are loading it to a non-first base pointer
-				data = dynamic_cast<T>(i->second);
+				data = dynamic_cast<T>(loadedPointers[pid]);
 				return;
 			}
 		}
@@ -324,7 +332,17 @@ public:
 	void ptrAllocated(T *ptr, uint32_t pid)
 	{
 		if(trackSerializedPointers && pid != 0xffffffff)
-			loadedPointers[pid] = const_cast<Serializeable*>(dynamic_cast<const Serializeable*>(ptr)); //add loaded pointer to our lookup map; cast is to avoid errors with const T* pt
+		{
+			//pids are given sequentially by serializer, reject anything else to avoid huge allocations on malformed input
+			if(pid > loadedPointers.size())
+			{
+				reader->reportState(logGlobal);
+				throw std::runtime_error("Invalid pointer id " + std::to_string(pid) + " during deserialization!");
+			}
+			if(pid == loadedPointers.size())
+				loadedPointers.push_back(nullptr);
+			loadedPointers[pid] = const_cast<Serializeable*>(dynamic_cast<const Serializeable*>(ptr)); //add loaded pointer to our lookup table; cast is to avoid errors with const T* pt
+		}
 	}
 
 	template <typename T>
@@ -459,6 +477,14 @@ public:
 			int32_t length;
 			load(length);
 
+			if (length == UNREGISTERED_STRING_MARKER && hasFeature(Version::SHARED_PACK_STRINGS))
+			{
+				uint32_t fullLength = readAndCheckLength();
+				data.resize(fullLength);
+				this->read(static_cast<void *>(data.data()), fullLength, false);
+				return;
+			}
+
 			if (length < 0)
 			{
 				int32_t stringID = -length - 1; // -1, -2 ... -> 0, 1 ...
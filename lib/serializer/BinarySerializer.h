@@ -84,8 +84,15 @@ class BinarySerializer : public CSaverBase
 public:
 	using Version = ESerializationVersion;
 
-	std::map<std::string, uint32_t> savedStrings;
-	std::map<const Serializeable*, uint32_t> savedPointers;
+	std::unordered_map<std::string, uint32_t> savedStrings;
+	std::unordered_map<const Serializeable*, uint32_t> savedPointers;
+
+	/// If set, strings are written in full and receiver does not add them to its string table
+	/// Result does not depend on previously saved data and can be sent to any receiver with same version
+	bool independentStrings = false;
+
+	/// Hashes of terrain chunks that receiver has cached, see TerrainChunkCache
+	const std::unordered_set<int64_t> * knownTerrainChunks = nullptr;
 
 	Version version = Version::CURRENT;
 	static constexpr bool trackSerializedPointers = true;
@@ -108,7 +115,8 @@ public:
 
 	void saveEncodedInteger(int64_t value)
 	{
-		uint64_t valueUnsigned = std::abs(value);
+		// negation in unsigned type is also defined for lowest possible value
+		uint64_t valueUnsigned = value < 0 ? -static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
 
 		while (valueUnsigned > 0x3f)
 		{
@@ -340,6 +348,15 @@ public:
 				return;
 			}
 
+			if (independentStrings)
+			{
+				assert(hasFeature(Version::SHARED_PACK_STRINGS));
+				save(UNREGISTERED_STRING_MARKER);
+				save(static_cast<uint32_t>(data.length()));
+				this->write(static_cast<const void *>(data.data()), data.size());
+				return;
+			}
+
 			auto it = savedStrings.find(data);
 
 			if (it == savedStrings.end())
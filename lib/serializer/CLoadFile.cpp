@@ -23,7 +23,28 @@ CLoadFile::~CLoadFile() = default;
 
 int CLoadFile::read(std::byte * data, unsigned size)
 {
-	sfile->read(reinterpret_cast<char *>(data), size);
+	static constexpr size_t chunkSize = 64 * 1024;
+	unsigned done = 0;
+
+	while(done < size)
+	{
+		if(bufferBegin == bufferEnd)
+		{
+			fileBuffer.resize(chunkSize);
+			sfile->read(reinterpret_cast<char *>(fileBuffer.data()), chunkSize);
+
+			if(sfile->gcount() == 0)
+				THROW_FORMAT("Error: unexpected end of file %s!", fName);
+
+			bufferBegin = fileBuffer.data();
+			bufferEnd = fileBuffer.data() + sfile->gcount();
+		}
+
+		unsigned available = std::min<unsigned>(size - done, bufferEnd - bufferBegin);
+		std::copy_n(bufferBegin, available, data + done);
+		bufferBegin += available;
+		done += available;
+	}
 	return size;
 }
 
@@ -37,14 +58,18 @@ void CLoadFile::openNextFile(const boost::filesystem::path & fname, ESerializati
 	{
 		fName = fname.string();
 		sfile = std::make_unique<std::fstream>(fname.c_str(), std::ios::in | std::ios::binary);
-		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
 
 		if(!(*sfile))
 			THROW_FORMAT("Error: cannot open to read %s!", fName);
 
+		//last chunk of file is usually incomplete, so only serious errors are reported via exceptions
+		sfile->exceptions(std::ifstream::badbit);
+		bufferBegin = nullptr;
+		bufferEnd = nullptr;
+
 		//we can read
 		char buffer[4];
-		sfile->read(buffer, 4);
+		read(reinterpret_cast<std::byte *>(buffer), 4);
 		if(std::memcmp(buffer, "VCMI", 4) != 0)
 			THROW_FORMAT("Error: not a VCMI file(%s)!", fName);
 
@@ -80,12 +105,15 @@ void CLoadFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CLoadFile");
 	if(!!sfile && *sfile)
-		out->debug("\tOpened %s Position: %d", fName, sfile->tellg());
+		out->debug("\tOpened %s Position: %d", fName, static_cast<int64_t>(sfile->tellg()) - (bufferEnd - bufferBegin));
 }
 
 void CLoadFile::clear()
 {
 	sfile = nullptr;
+	fileBuffer.clear();
+	bufferBegin = nullptr;
+	bufferEnd = nullptr;
 	fName.clear();
 	serializer.version = ESerializationVersion::NONE;
 }
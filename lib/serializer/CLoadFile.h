@@ -20,6 +20,7 @@ public:
 
 	std::string fName;
 	std::unique_ptr<std::fstream> sfile;
+	std::vector<std::byte> fileBuffer; //file is read in chunks, deserializer takes data from it via bufferBegin/bufferEnd
 
 	CLoadFile(const boost::filesystem::path & fname, ESerializationVersion minimalVersion = ESerializationVersion::CURRENT); //throws!
 	virtual ~CLoadFile();
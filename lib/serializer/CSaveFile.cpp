@@ -12,39 +12,67 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Sizes of data and pointer and string tables from previous save, used to reserve space for next one
+static std::atomic<size_t> previousSaveSize = 0;
+static std::atomic<size_t> previousSavedPointers = 0;
+static std::atomic<size_t> previousSavedStrings = 0;
+
 CSaveFile::CSaveFile(const boost::filesystem::path &fname)
 	: serializer(this)
+	, fName(fname)
 {
-	openNextFile(fname);
+	buffer.reserve(previousSaveSize);
+	serializer.savedPointers.reserve(previousSavedPointers);
+	serializer.savedStrings.reserve(previousSavedStrings);
+
+	putMagicBytes("VCMI"); //write magic identifier
+	serializer & ESerializationVersion::CURRENT; //write format version
 }
 
 //must be instantiated in .cpp file for access to complete types of all member fields
-CSaveFile::~CSaveFile() = default;
+CSaveFile::~CSaveFile()
+{
+	// file may be destroyed without writing if serialization has failed with exception, this is expected
+	if(!writeAttempted && std::uncaught_exceptions() == 0)
+		logGlobal->error("Data for %s was discarded without writing it to disk!", fName.string());
+
+	previousSaveSize = buffer.size();
+	previousSavedPointers = serializer.savedPointers.size();
+	previousSavedStrings = serializer.savedStrings.size();
+}
 
 int CSaveFile::write(const std::byte * data, unsigned size)
 {
-	sfile->write(reinterpret_cast<const char *>(data), size);
+	buffer.insert(buffer.end(), data, data + size);
 	return size;
 }
 
-void CSaveFile::openNextFile(const boost::filesystem::path &fname)
+void CSaveFile::writeToDisk()
 {
-	fName = fname;
+	// failure to write is reported by exception, so file is not reported again on destruction
+	writeAttempted = true;
+
+	// write into temporary file first, so crash during write or concurrent reader never sees partially written file
+	const auto tempName = boost::filesystem::unique_path(fName.string() + ".%%%%%%%%");
+
 	try
 	{
-		sfile = std::make_unique<std::fstream>(fname.c_str(), std::ios::out | std::ios::binary);
-		sfile->exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
+		{
+			std::fstream sfile(tempName.c_str(), std::ios::out | std::ios::binary);
+			sfile.exceptions(std::ifstream::failbit | std::ifstream::badbit); //we throw a lot anyway
 
-		if(!(*sfile))
-			THROW_FORMAT("Error: cannot open to write %s!", fname);
+			if(!sfile)
+				THROW_FORMAT("Error: cannot open to write %s!", tempName);
 
-		sfile->write("VCMI",4); //write magic identifier
-		serializer & ESerializationVersion::CURRENT; //write format version
+			sfile.write(reinterpret_cast<const char *>(buffer.data()), buffer.size());
+		}
+		boost::filesystem::rename(tempName, fName);
 	}
 	catch(...)
 	{
-		logGlobal->error("Failed to save to %s", fname.string());
-		clear();
+		logGlobal->error("Failed to save to %s", fName.string());
+		boost::system::error_code ec;
+		boost::filesystem::remove(tempName, ec);
 		throw;
 	}
 }
@@ -52,16 +80,7 @@ void CSaveFile::openNextFile(const boost::filesystem::path &fname)
 void CSaveFile::reportState(vstd::CLoggerBase * out)
 {
 	out->debug("CSaveFile");
-	if(sfile.get() && *sfile)
-	{
-		out->debug("\tOpened %s \tPosition: %d", fName, sfile->tellp());
-	}
-}
-
-void CSaveFile::clear()
-{
-	fName.clear();
-	sfile = nullptr;
+	out->debug("\tSerializing %s \tPosition: %d", fName, buffer.size());
 }
 
 void CSaveFile::putMagicBytes(const std::string &text)
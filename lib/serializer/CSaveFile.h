@@ -13,20 +13,24 @@
 
 VCMI_LIB_NAMESPACE_BEGIN
 
+/// Serializes data into memory buffer. Actual file is written only by writeToDisk()
+/// so it may be done on another thread once serialization is over
+/// Data of file that is destroyed without writeToDisk() call is discarded
 class DLL_LINKAGE CSaveFile : public IBinaryWriter
 {
+	bool writeAttempted = false;
+
 public:
 	BinarySerializer serializer;
 
 	boost::filesystem::path fName;
-	std::unique_ptr<std::fstream> sfile;
+	std::vector<std::byte> buffer;
 
-	CSaveFile(const boost::filesystem::path &fname); //throws!
+	CSaveFile(const boost::filesystem::path &fname);
 	~CSaveFile();
 	int write(const std::byte * data, unsigned size) override;
 
-	void openNextFile(const boost::filesystem::path &fname); //throws!
-	void clear();
+	void writeToDisk(); //throws!
 	void reportState(vstd::CLoggerBase * out) override;
 
 	void putMagicBytes(const std::string &text);
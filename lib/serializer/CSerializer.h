@@ -16,6 +16,9 @@ VCMI_LIB_NAMESPACE_BEGIN
 
 const std::string SAVEGAME_MAGIC = "VCMISVG";
 
+/// Length of serialized string that is followed by string that receiver must not add to its string table
+constexpr int32_t UNREGISTERED_STRING_MARKER = std::numeric_limits<int32_t>::min();
+
 class CHero;
 class CGHeroInstance;
 class CGObjectInstance;
@@ -175,6 +178,11 @@ struct VectorizedIDType<CGHeroInstance>
 class DLL_LINKAGE IBinaryReader : public virtual CSerializer
 {
 public:
+	/// Not yet read part of data, if reader keeps it in contiguous memory.
+	/// Deserializer takes data directly from it and calls read() only once it is exhausted
+	const std::byte * bufferBegin = nullptr;
+	const std::byte * bufferEnd = nullptr;
+
 	virtual int read(std::byte * data, unsigned size) = 0;
 };
 
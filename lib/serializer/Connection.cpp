@@ -17,6 +17,8 @@
 #include "../networkPacks/NetPacksBase.h"
 #include "../network/NetworkInterface.h"
 
+#include <zlib.h>
+
 VCMI_LIB_NAMESPACE_BEGIN
 
 class DLL_LINKAGE ConnectionPackWriter final : public IBinaryWriter
@@ -27,15 +29,64 @@ public:
 	int write(const std::byte * data, unsigned size) final;
 };
 
+/// Received pack is kept in memory as whole, so all data is read directly from bufferBegin/bufferEnd range
 class DLL_LINKAGE ConnectionPackReader final : public IBinaryReader
 {
 public:
-	const std::vector<std::byte> * buffer;
-	size_t position;
-
 	int read(std::byte * data, unsigned size) final;
 };
 
+/// Serialized pack always starts with zero byte of "is null" flag, so compressed packs use different first byte as marker
+/// Compressed pack layout: marker, size of decompressed pack, zlib-compressed data
+static constexpr std::byte compressedPackMarker{0xC0};
+static constexpr size_t compressedPackHeaderSize = 1 + sizeof(uint32_t);
+static constexpr size_t compressionThreshold = 4 * 1024;
+static constexpr size_t decompressedPackMaxSize = 64 * 1024 * 1024;
+static constexpr size_t retainedBufferMaxSize = 1024 * 1024;
+
+/// Returns false if pack should be sent as it is, since compression would not make it smaller
+static bool compressPack(const std::vector<std::byte> & data, std::vector<std::byte> & result)
+{
+	if (data.size() < compressionThreshold)
+		return false;
+
+	uint32_t decompressedSize = data.size();
+	uLongf compressedSize = compressBound(data.size());
+
+	result.resize(compressedPackHeaderSize + compressedSize);
+	result[0] = compressedPackMarker;
+	std::memcpy(result.data() + 1, &decompressedSize, sizeof(decompressedSize));
+
+	int status = compress2(reinterpret_cast<Bytef *>(result.data() + compressedPackHeaderSize), &compressedSize, reinterpret_cast<const Bytef *>(data.data()), data.size(), Z_DEFAULT_COMPRESSION);
+	if (status != Z_OK)
+	{
+		logNetwork->warn("Failed to compress pack, error code %d", status);
+		return false;
+	}
+
+	result.resize(compressedPackHeaderSize + compressedSize);
+	return result.size() < data.size();
+}
+
+static void decompressPack(const std::vector<std::byte> & data, std::vector<std::byte> & result)
+{
+	if (data.size() < compressedPackHeaderSize)
+		throw std::runtime_error("Failed to decompress pack! Pack is too small!");
+
+	uint32_t expectedSize;
+	std::memcpy(&expectedSize, data.data() + 1, sizeof(expectedSize));
+
+	if (expectedSize > decompressedPackMaxSize)
+		throw std::runtime_error("Failed to decompress pack! Invalid pack size!");
+
+	result.resize(expectedSize);
+	uLongf decompressedSize = expectedSize;
+
+	int status = uncompress(reinterpret_cast<Bytef *>(result.data()), &decompressedSize, reinterpret_cast<const Bytef *>(data.data() + compressedPackHeaderSize), data.size() - compressedPackHeaderSize);
+	if (status != Z_OK || decompressedSize != expectedSize)
+		throw std::runtime_error("Failed to decompress pack! Error code " + std::to_string(status));
+}
+
 int ConnectionPackWriter::write(const std::byte * data, unsigned size)
 {
 	buffer.insert(buffer.end(), data, data + size);
@@ -44,11 +95,11 @@ int ConnectionPackWriter::write(const std::byte * data, unsigned size)
 
 int ConnectionPackReader::read(std::byte * data, unsigned size)
 {
-	if (position + size > buffer->size())
+	if (bufferEnd - bufferBegin < static_cast<ptrdiff_t>(size))
 		throw std::runtime_error("End of file reached when reading received network pack!");
 
-	std::copy_n(buffer->begin() + position, size, data);
-	position += size;
+	std::copy_n(bufferBegin, size, data);
+	bufferBegin += size;
 	return size;
 }
 
@@ -82,26 +133,93 @@ void CConnection::sendPack(const CPack & pack)
 
 	logNetwork->trace("Sending a pack of type %s", typeid(pack).name());
 
-	connectionPtr->sendPacket(packWriter->buffer);
+	if (packCompressionEnabled && compressPack(packWriter->buffer, compressedData))
+		connectionPtr->sendPacket(compressedData);
+	else
+		connectionPtr->sendPacket(packWriter->buffer);
+
+	if (compressedData.capacity() > retainedBufferMaxSize)
+	{
+		compressedData.clear();
+		compressedData.shrink_to_fit();
+	}
+
 	packWriter->buffer.clear();
 	serializer->savedPointers.clear();
 }
 
+SerializedPack CConnection::serializePack(const CPack & pack)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	SerializedPack result;
+	BinarySerializer independentSerializer(packWriter.get());
+	independentSerializer.version = serializer->version;
+	independentSerializer.independentStrings = true;
+
+	packWriter->buffer.clear();
+	independentSerializer & (&pack);
+
+	std::vector<std::byte> compressed;
+	if (packCompressionEnabled && compressPack(packWriter->buffer, compressed))
+		result.data = std::make_shared<const std::vector<std::byte>>(std::move(compressed));
+	else
+		result.data = std::make_shared<const std::vector<std::byte>>(std::move(packWriter->buffer));
+	packWriter->buffer.clear();
+	return result;
+}
+
+void CConnection::sendPack(const SerializedPack & pack)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+
+	auto connectionPtr = networkConnection.lock();
+
+	if (!connectionPtr)
+		throw std::runtime_error("Attempt to send packet on a closed connection!");
+
+	connectionPtr->sendPacket(*pack.data);
+}
+
+bool CConnection::canShareSerializedPacks(const CConnection & other) const
+{
+	return serializer->version >= ESerializationVersion::SHARED_PACK_STRINGS
+		&& serializer->version == other.serializer->version
+		&& packWriter->smartVectorMembersSerialization == other.packWriter->smartVectorMembersSerialization
+		&& packWriter->sendStackInstanceByIds == other.packWriter->sendStackInstanceByIds;
+}
+
 std::unique_ptr<CPack> CConnection::retrievePack(const std::vector<std::byte> & data)
 {
 	std::unique_ptr<CPack> result;
+	const std::vector<std::byte> * packData = &data;
+
+	if (!data.empty() && data.front() == compressedPackMarker)
+	{
+		decompressPack(data, decompressedData);
+		packData = &decompressedData;
+	}
 
-	packReader->buffer = &data;
-	packReader->position = 0;
+	packReader->bufferBegin = packData->data();
+	packReader->bufferEnd = packData->data() + packData->size();
 
 	*deserializer & result;
 
 	if (result == nullptr)
 		throw std::runtime_error("Failed to retrieve pack!");
 
-	if (packReader->position != data.size())
+	if (packReader->bufferBegin != packReader->bufferEnd)
 		throw std::runtime_error("Failed to retrieve pack! Not all data has been read!");
 
+	packReader->bufferBegin = nullptr;
+	packReader->bufferEnd = nullptr;
+
+	if (decompressedData.capacity() > retainedBufferMaxSize)
+	{
+		decompressedData.clear();
+		decompressedData.shrink_to_fit();
+	}
+
 	logNetwork->trace("Received CPack of type %s", typeid(result.get()).name());
 	deserializer->loadedPointers.clear();
 	deserializer->loadedSharedPointers.clear();
@@ -163,10 +281,23 @@ void CConnection::enableSmartVectorMemberSerializatoin(CGameState * gs)
 	packReader->addStdVecItems(gs);
 }
 
+void CConnection::setKnownTerrainChunks(const std::vector<int64_t> & hashes)
+{
+	boost::mutex::scoped_lock lock(writeMutex);
+	knownTerrainChunks = std::unordered_set<int64_t>(hashes.begin(), hashes.end());
+	serializer->knownTerrainChunks = &knownTerrainChunks;
+}
+
+void CConnection::setTerrainChunkCache(const TerrainChunkCache * cache)
+{
+	deserializer->terrainChunkCache = cache;
+}
+
 void CConnection::setSerializationVersion(ESerializationVersion version)
 {
 	deserializer->version = version;
 	serializer->version = version;
+	packCompressionEnabled = version >= ESerializationVersion::COMPRESSED_NETWORK_PACKS;
 }
 
 VCMI_LIB_NAMESPACE_END
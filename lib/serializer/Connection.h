@@ -21,6 +21,13 @@ class ConnectionPackReader;
 class ConnectionPackWriter;
 class CGameState;
 class IGameCallback;
+class TerrainChunkCache;
+
+/// Pack that was serialized once to be sent to multiple connections
+struct DLL_LINKAGE SerializedPack
+{
+	std::shared_ptr<const std::vector<std::byte>> data;
+};
 
 /// Wrapper class for game connection
 /// Handles serialization and deserialization of data received from network
@@ -36,6 +43,13 @@ class DLL_LINKAGE CConnection : boost::noncopyable
 
 	boost::mutex writeMutex;
 
+	/// Enabled once both sides agreed on serialization version that supports it
+	bool packCompressionEnabled = false;
+	std::vector<std::byte> compressedData;
+	std::vector<std::byte> decompressedData;
+
+	std::unordered_set<int64_t> knownTerrainChunks;
+
 	void disableStackSendingByID();
 	void enableStackSendingByID();
 	void disableSmartVectorMemberSerialization();
@@ -52,12 +66,22 @@ public:
 	~CConnection();
 
 	void sendPack(const CPack & pack);
+
+	/// Serializes pack independently from previously sent data, so result can be sent via any connection with same serialization settings
+	SerializedPack serializePack(const CPack & pack);
+	void sendPack(const SerializedPack & pack);
+	bool canShareSerializedPacks(const CConnection & other) const;
 	std::unique_ptr<CPack> retrievePack(const std::vector<std::byte> & data);
 
 	void enterLobbyConnectionMode();
 	void setCallback(IGameCallback * cb);
 	void enterGameplayConnectionMode(CGameState * gs);
 	void setSerializationVersion(ESerializationVersion version);
+
+	/// Terrain chunks that other side has in its cache, these will be sent without static data
+	void setKnownTerrainChunks(const std::vector<int64_t> & hashes);
+	/// Cache used to restore terrain chunks that were sent without static data
+	void setTerrainChunkCache(const TerrainChunkCache * cache);
 };
 
 VCMI_LIB_NAMESPACE_END
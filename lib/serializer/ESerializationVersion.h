@@ -65,6 +65,11 @@ enum class ESerializationVersion : int32_t
 	LOCAL_PLAYER_STATE_DATA, // 866 - player state contains arbitrary client-side data
 	REMOVE_TOWN_PTR, // 867 - removed pointer to CTown from CGTownInstance
 	REMOVE_OBJECT_TYPENAME, // 868 - remove typename from CGObjectInstance
+	COMPRESSED_NETWORK_PACKS, // 869 - large network packs may be sent compressed
+	TERRAIN_CHUNKS, // 870 - map terrain is serialized in chunks, receiver may have static part of chunk cached
+	SHARED_PACK_STRINGS, // 871 - strings of packs sent to multiple connections are not added to string table of receiver
+	COMPACT_CONTENT_CACHE, // 872 - preloaded mod data in content cache is stored as CompactJsonTree
+	TERRAIN_CHUNK_GENERATIONS, // 873 - server acknowledges cached terrain chunks, so client can discard chunks of older maps
 
-	CURRENT = REMOVE_OBJECT_TYPENAME
+	CURRENT = TERRAIN_CHUNK_GENERATIONS
 };
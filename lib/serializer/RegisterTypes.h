@@ -291,6 +291,8 @@ void registerTypes(Serializer &s)
 	s.template registerType<SpellResearch>(241);
 	s.template registerType<SetResearchedSpells>(242);
 	s.template registerType<SaveLocalState>(243);
+	s.template registerType<LobbyCachedTerrainChunks>(244);
+	s.template registerType<LobbyCachedTerrainChunksAccepted>(245);
 }
 
 VCMI_LIB_NAMESPACE_END
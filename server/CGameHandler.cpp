@@ -520,6 +520,7 @@ CGameHandler::CGameHandler(CVCMIServer * lobby)
 
 CGameHandler::~CGameHandler()
 {
+	waitForSaveToFinish();
 	delete spellEnv;
 	delete gs;
 	gs = nullptr;
@@ -1437,8 +1438,30 @@ void CGameHandler::heroExchange(ObjectInstanceID hero1, ObjectInstanceID hero2)
 void CGameHandler::sendToAllClients(CPackForClient & pack)
 {
 	logNetwork->trace("\tSending to all clients: %s", typeid(pack).name());
-	for (auto c : lobby->activeConnections)
-		c->sendPack(pack);
+
+	// Connections with same serialization settings can receive same data, so pack is serialized once per group
+	std::vector<std::vector<std::shared_ptr<CConnection>>> groups;
+	for (const auto & c : lobby->activeConnections)
+	{
+		auto group = boost::range::find_if(groups, [&c](const auto & g){ return g.front()->canShareSerializedPacks(*c); });
+		if (group == groups.end())
+			groups.push_back({c});
+		else
+			group->push_back(c);
+	}
+
+	for (const auto & group : groups)
+	{
+		if (group.size() == 1)
+		{
+			group.front()->sendPack(pack);
+			continue;
+		}
+
+		auto serialized = group.front()->serializePack(pack);
+		for (const auto & c : group)
+			c->sendPack(serialized);
+	}
 }
 
 void CGameHandler::sendAndApply(CPackForClient & pack)
@@ -1533,20 +1556,44 @@ void CGameHandler::save(const std::string & filename)
 	ResourcePath savePath(stem.to_string(), EResType::SAVEGAME);
 	CResourceHandler::get("local")->createResource(savefname);
 
+	std::shared_ptr<CSaveFile> save;
 	try
 	{
-		{
-			CSaveFile save(*CResourceHandler::get("local")->getResourceName(savePath));
-			saveCommonState(save);
-			logGlobal->info("Saving server state");
-			save << *this;
-		}
-		logGlobal->info("Game has been successfully saved!");
+		save = std::make_shared<CSaveFile>(*CResourceHandler::get("local")->getResourceName(savePath));
+		saveCommonState(*save);
+		logGlobal->info("Saving server state");
+		*save << *this;
 	}
 	catch(std::exception &e)
 	{
 		logGlobal->error("Failed to save game: %s", e.what());
+		return;
 	}
+
+	// Game state is now serialized in memory, so it can be written to disk while game continues
+	waitForSaveToFinish();
+	saveThread = std::make_unique<boost::thread>([save, filename]()
+	{
+		setThreadName("saveWriter");
+		try
+		{
+			save->writeToDisk();
+			logGlobal->info("Game has been saved as %s", filename);
+		}
+		catch(std::exception &e)
+		{
+			logGlobal->error("Failed to save game: %s", e.what());
+		}
+	});
+}
+
+void CGameHandler::waitForSaveToFinish()
+{
+	if(!saveThread)
+		return;
+
+	saveThread->join();
+	saveThread.reset();
 }
 
 bool CGameHandler::load(const std::string & filename)
@@ -1554,6 +1601,7 @@ bool CGameHandler::load(const std::string & filename)
 	logGlobal->info("Loading from %s", filename);
 	const auto stem	= FileInfo::GetPathStem(filename);
 
+	waitForSaveToFinish();
 	reinitScripting();
 
 	try
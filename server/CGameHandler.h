@@ -57,6 +57,10 @@ class CGameHandler : public IGameCallback, public Environment
 {
 	CVCMIServer * lobby;
 
+	/// Writes already serialized save to disk, so game does not wait for it
+	std::unique_ptr<boost::thread> saveThread;
+	void waitForSaveToFinish();
+
 public:
 	std::unique_ptr<HeroPoolProcessor> heroPool;
 	std::unique_ptr<BattleProcessor> battles;
@@ -433,3 +433,24 @@ void ApplyOnServerNetPackVisitor::visitLobbyPvPAction(LobbyPvPAction & pack)
 	}
 	result = true;
 }
+
+void ClientPermissionsCheckerNetPackVisitor::visitLobbyCachedTerrainChunks(LobbyCachedTerrainChunks & pack)
+{
+	result = true;
+}
+
+void ApplyOnServerNetPackVisitor::visitLobbyCachedTerrainChunks(LobbyCachedTerrainChunks & pack)
+{
+	pack.c->setKnownTerrainChunks(pack.hashes);
+
+	// chunks of older generations will no longer be used, so client may discard them
+	if(pack.generation != 0)
+	{
+		LobbyCachedTerrainChunksAccepted accepted;
+		accepted.generation = pack.generation;
+		pack.c->sendPack(accepted);
+	}
+
+	// only affects connection of this client, nothing to announce
+	result = false;
+}
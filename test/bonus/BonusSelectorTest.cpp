@@ -0,0 +1,64 @@
+/*
+ * BonusSelectorTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/bonuses/BonusSelector.h"
+
+TEST(BonusSelectorTest, evaluatesFieldChecks)
+{
+	Bonus bonus(BonusDuration::ONE_DAY, BonusType::PRIMARY_SKILL, BonusSource::ARTIFACT, 1, BonusSourceID(ArtifactID(5)), BonusSubtypeID(PrimarySkill::ATTACK));
+
+	EXPECT_TRUE(Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::ATTACK))(&bonus));
+	EXPECT_FALSE(Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::DEFENSE))(&bonus));
+	EXPECT_TRUE(Selector::source(BonusSource::ARTIFACT, BonusSourceID(ArtifactID(5)))(&bonus));
+	EXPECT_FALSE(Selector::source(BonusSource::ARTIFACT, BonusSourceID(SpellID(5)))(&bonus));
+	EXPECT_TRUE(CSelector(Bonus::OneDay)(&bonus));
+	EXPECT_FALSE(CSelector(Bonus::OneWeek)(&bonus));
+
+	EXPECT_TRUE(Selector::type()(BonusType::LUCK).Or(Selector::sourceType()(BonusSource::ARTIFACT))(&bonus));
+	EXPECT_FALSE(Selector::type()(BonusType::PRIMARY_SKILL).And(Selector::sourceType()(BonusSource::ARTIFACT)).Not()(&bonus));
+	EXPECT_TRUE(Selector::all(&bonus));
+	EXPECT_FALSE(Selector::none(&bonus));
+}
+
+TEST(BonusSelectorTest, structurallyEqualSelectorsHaveSameHash)
+{
+	auto first = Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::ATTACK));
+	auto second = Selector::type()(BonusType::PRIMARY_SKILL).And(Selector::subtype()(BonusSubtypeID(PrimarySkill::ATTACK)));
+	auto other = Selector::typeSubtype(BonusType::PRIMARY_SKILL, BonusSubtypeID(PrimarySkill::DEFENSE));
+
+	EXPECT_TRUE(first.isCacheable());
+	EXPECT_EQ(first, second);
+	EXPECT_EQ(first.hash(), second.hash());
+	EXPECT_FALSE(first == other);
+	EXPECT_EQ(Selector::all.And(first), first);
+}
+
+TEST(BonusSelectorTest, functorsAreNotCacheable)
+{
+	CSelector functor([](const Bonus * b){ return b->val > 0; });
+	auto combined = Selector::type()(BonusType::LUCK).And(functor);
+
+	EXPECT_FALSE(functor.isCacheable());
+	EXPECT_FALSE(combined.isCacheable());
+
+	Bonus bonus(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::OTHER, 1, BonusSourceID());
+	EXPECT_TRUE(combined(&bonus));
+	bonus.val = 0;
+	EXPECT_FALSE(combined(&bonus));
+}
+
+TEST(BonusSelectorTest, requiredType)
+{
+	EXPECT_EQ(Selector::type()(BonusType::LUCK).requiredType(), BonusType::LUCK);
+	EXPECT_EQ(Selector::sourceType()(BonusSource::ARTIFACT).And(Selector::type()(BonusType::MORALE)).requiredType(), BonusType::MORALE);
+	EXPECT_FALSE(Selector::type()(BonusType::LUCK).Or(Selector::type()(BonusType::MORALE)).requiredType().has_value());
+	EXPECT_FALSE(Selector::all.requiredType().has_value());
+}
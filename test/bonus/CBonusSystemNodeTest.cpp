@@ -0,0 +1,101 @@
+/*
+ * CBonusSystemNodeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/bonuses/Bonus.h"
+#include "../lib/bonuses/CBonusSystemNode.h"
+
+class CBonusSystemNodeTest : public ::testing::Test
+{
+public:
+	CBonusSystemNode grandparent;
+	CBonusSystemNode parent;
+	CBonusSystemNode sibling;
+	CBonusSystemNode child;
+
+	void SetUp() override
+	{
+		// grandparent -> parent -> child
+		//             -> sibling
+		parent.attachTo(grandparent);
+		sibling.attachTo(grandparent);
+		child.attachTo(parent);
+	}
+
+	void TearDown() override
+	{
+		child.detachFromAll();
+		sibling.detachFromAll();
+		parent.detachFromAll();
+	}
+
+	static std::shared_ptr<Bonus> luckBonus(int value)
+	{
+		return std::make_shared<Bonus>(BonusDuration::PERMANENT, BonusType::LUCK, BonusSource::OTHER, value, BonusSourceID());
+	}
+};
+
+TEST_F(CBonusSystemNodeTest, attachingParentUpdatesCachedValue)
+{
+	CBonusSystemNode other;
+	other.addNewBonus(luckBonus(2));
+
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 0);
+
+	child.attachTo(other);
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 2);
+
+	child.detachFrom(other);
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, bonusOfGrandparentUpdatesCachedValue)
+{
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 0);
+
+	auto bonus = luckBonus(3);
+	grandparent.addNewBonus(bonus);
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 3);
+
+	grandparent.removeBonus(bonus);
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 0);
+}
+
+TEST_F(CBonusSystemNodeTest, siblingCacheIsNotInvalidated)
+{
+	EXPECT_EQ(sibling.valOfBonuses(BonusType::LUCK), 0);
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 0);
+
+	const int64_t siblingVersion = sibling.getTreeVersion();
+	const int64_t childVersion = child.getTreeVersion();
+
+	parent.addNewBonus(luckBonus(1));
+
+	EXPECT_EQ(sibling.getTreeVersion(), siblingVersion);
+	EXPECT_NE(child.getTreeVersion(), childVersion);
+	EXPECT_EQ(sibling.valOfBonuses(BonusType::LUCK), 0);
+	EXPECT_EQ(child.valOfBonuses(BonusType::LUCK), 1);
+}
+
+TEST_F(CBonusSystemNodeTest, hypotheticNodeSeesParentChanges)
+{
+	CBonusSystemNode hypothetic(true);
+	hypothetic.attachTo(parent);
+
+	EXPECT_EQ(hypothetic.valOfBonuses(BonusType::LUCK), 0);
+
+	grandparent.addNewBonus(luckBonus(2));
+	EXPECT_EQ(hypothetic.valOfBonuses(BonusType::LUCK), 2);
+
+	parent.addNewBonus(luckBonus(1));
+	EXPECT_EQ(hypothetic.valOfBonuses(BonusType::LUCK), 3);
+
+	hypothetic.detachFrom(parent);
+}
@@ -0,0 +1,237 @@
+/*
+ * CArchiveLoaderTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/filesystem/CArchiveLoader.h"
+#include "../lib/filesystem/CCompressedStream.h"
+#include "../lib/filesystem/CFileInputStream.h"
+
+#include <zlib.h>
+
+namespace
+{
+
+std::vector<ui8> makeContent(size_t size, int seed)
+{
+	std::vector<ui8> result(size);
+	uint32_t state = seed;
+	for(auto & byte : result)
+	{
+		// mix of repeated and varying bytes, so data compresses but needs several inflate blocks
+		state = state * 1103515245 + 12345;
+		byte = static_cast<ui8>('a' + (state >> 16) % 8);
+	}
+	return result;
+}
+
+std::vector<ui8> compress(const std::vector<ui8> & data)
+{
+	uLongf compressedSize = compressBound(data.size());
+	std::vector<ui8> result(compressedSize);
+
+	if(compress2(result.data(), &compressedSize, data.data(), data.size(), Z_DEFAULT_COMPRESSION) != Z_OK)
+		throw std::runtime_error("Failed to compress test data");
+
+	result.resize(compressedSize);
+	return result;
+}
+
+/// Small .lod archive with one uncompressed and two compressed entries
+/// Last entry declares larger size than its data actually has
+class CArchiveLoaderTest : public ::testing::Test
+{
+public:
+	static constexpr size_t PLAIN_SIZE = 1000;
+	static constexpr size_t PACKED_SIZE = 50000;
+	static constexpr size_t SHORT_SIZE = 3000;
+	static constexpr size_t SHORT_DECLARED_SIZE = 4000;
+
+	boost::filesystem::path archivePath;
+	std::vector<ui8> plain = makeContent(PLAIN_SIZE, 1);
+	std::vector<ui8> packed = makeContent(PACKED_SIZE, 2);
+	std::vector<ui8> shortData = makeContent(SHORT_SIZE, 3);
+	std::unique_ptr<CArchiveLoader> loader;
+
+	void SetUp() override
+	{
+		archivePath = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("vcmi-test-%%%%%%%%.lod");
+
+		struct Entry
+		{
+			std::string name;
+			std::vector<ui8> data;
+			size_t fullSize;
+			bool compressed;
+		};
+
+		std::vector<Entry> entries = {
+			{"PLAIN.TXT", plain, plain.size(), false},
+			{"PACKED.TXT", compress(packed), packed.size(), true},
+			{"SHORT.TXT", compress(shortData), SHORT_DECLARED_SIZE, true}
+		};
+
+		const size_t headerSize = 0x5c;
+		const size_t entrySize = 32;
+		std::vector<ui8> archive(headerSize + entrySize * entries.size());
+
+		auto writeUInt32 = [&archive](size_t position, uint32_t value)
+		{
+			for(int i = 0; i < 4; ++i)
+				archive[position + i] = static_cast<ui8>(value >> (i * 8));
+		};
+
+		std::copy_n("LOD", 4, archive.begin());
+		writeUInt32(8, entries.size());
+
+		for(size_t i = 0; i < entries.size(); ++i)
+		{
+			const size_t position = headerSize + i * entrySize;
+			std::copy(entries[i].name.begin(), entries[i].name.end(), archive.begin() + position);
+			writeUInt32(position + 16, archive.size());
+			writeUInt32(position + 20, entries[i].fullSize);
+			writeUInt32(position + 28, entries[i].compressed ? entries[i].data.size() : 0);
+			archive.insert(archive.end(), entries[i].data.begin(), entries[i].data.end());
+		}
+
+		std::ofstream file(archivePath.c_str(), std::ios::binary);
+		file.write(reinterpret_cast<const char *>(archive.data()), archive.size());
+		file.close();
+
+		loader = std::make_unique<CArchiveLoader>("DATA/", archivePath);
+	}
+
+	void TearDown() override
+	{
+		loader.reset();
+		boost::system::error_code ec;
+		boost::filesystem::remove(archivePath, ec);
+	}
+
+	std::unique_ptr<CInputStream> loadMapped(const std::string & name) const
+	{
+		return loader->load(ResourcePath("DATA/" + name));
+	}
+
+	/// Opens entry the same way as archive loader does when archive could not be mapped into memory
+	std::unique_ptr<CInputStream> loadFromFile(const std::string & name) const
+	{
+		const ArchiveEntry & entry = loader->getEntries().at(ResourcePath("DATA/" + name));
+
+		if(entry.compressedSize != 0)
+		{
+			auto fileStream = std::make_unique<CFileInputStream>(archivePath, entry.offset, entry.compressedSize);
+			return std::make_unique<CCompressedStream>(std::move(fileStream), false, entry.fullSize);
+		}
+		return std::make_unique<CFileInputStream>(archivePath, entry.offset, entry.fullSize);
+	}
+
+	static std::vector<ui8> readAll(CInputStream & stream, si64 requestSize)
+	{
+		std::vector<ui8> result(requestSize);
+		result.resize(stream.read(result.data(), requestSize));
+		return result;
+	}
+
+	/// Reads entry in small pieces, mixing reads with seeks and skips, and compares result with data read via file stream
+	void checkPartialAccess(const std::string & name) const
+	{
+		auto mapped = loadMapped(name);
+		auto file = loadFromFile(name);
+
+		EXPECT_EQ(mapped->skip(100), 100);
+		file->skip(100);
+		EXPECT_EQ(mapped->tell(), file->tell());
+		EXPECT_EQ(readAll(*mapped, 50), readAll(*file, 50));
+
+		// return value of seek differs between stream types, so only resulting positions are compared
+		mapped->seek(500);
+		file->seek(500);
+		EXPECT_EQ(mapped->tell(), 500);
+		EXPECT_EQ(readAll(*mapped, 700), readAll(*file, 700));
+		EXPECT_EQ(mapped->tell(), file->tell());
+
+		mapped->seek(0);
+		file->seek(0);
+		EXPECT_EQ(readAll(*mapped, 10), readAll(*file, 10));
+
+		EXPECT_EQ(mapped->getSize(), file->getSize());
+		mapped->seek(std::numeric_limits<si32>::max());
+		EXPECT_EQ(mapped->tell(), mapped->getSize());
+		EXPECT_TRUE(readAll(*mapped, 10).empty());
+
+		// compressed file stream reports full requested size on reads past the end, so it is only used for data within entry
+		mapped->seek(mapped->getSize() - 5);
+		file->seek(file->getSize() - 5);
+		EXPECT_EQ(readAll(*mapped, 100), readAll(*file, 5));
+	}
+};
+
+}
+
+TEST_F(CArchiveLoaderTest, uncompressedEntry)
+{
+	auto mapped = loadMapped("PLAIN.TXT");
+	auto file = loadFromFile("PLAIN.TXT");
+
+	EXPECT_EQ(mapped->getSize(), PLAIN_SIZE);
+	EXPECT_EQ(mapped->getSize(), file->getSize());
+	EXPECT_EQ(readAll(*mapped, PLAIN_SIZE), plain);
+	EXPECT_EQ(readAll(*file, PLAIN_SIZE), plain);
+
+	checkPartialAccess("PLAIN.TXT");
+}
+
+TEST_F(CArchiveLoaderTest, compressedEntryReadAtOnce)
+{
+	// whole entry is requested from start, so it is inflated directly into output buffer
+	auto mapped = loadMapped("PACKED.TXT");
+	auto file = loadFromFile("PACKED.TXT");
+
+	EXPECT_EQ(mapped->getSize(), PACKED_SIZE);
+	EXPECT_EQ(readAll(*mapped, PACKED_SIZE), packed);
+	EXPECT_EQ(readAll(*file, PACKED_SIZE), packed);
+	EXPECT_EQ(mapped->tell(), PACKED_SIZE);
+	EXPECT_TRUE(readAll(*mapped, 10).empty());
+
+	// already read data is not kept, but is decompressed again on request
+	mapped->seek(PACKED_SIZE - 10);
+	EXPECT_EQ(readAll(*mapped, 10), std::vector<ui8>(packed.end() - 10, packed.end()));
+}
+
+TEST_F(CArchiveLoaderTest, compressedEntryPartialAccess)
+{
+	// reads of parts of entry go through internal buffer that is filled on first access
+	checkPartialAccess("PACKED.TXT");
+
+	auto mapped = loadMapped("PACKED.TXT");
+	EXPECT_EQ(readAll(*mapped, 10), std::vector<ui8>(packed.begin(), packed.begin() + 10));
+	EXPECT_EQ(readAll(*mapped, PACKED_SIZE), std::vector<ui8>(packed.begin() + 10, packed.end()));
+}
+
+TEST_F(CArchiveLoaderTest, compressedEntryShorterThanDeclared)
+{
+	// before entry is decompressed only size from archive header is known
+	EXPECT_EQ(loadMapped("SHORT.TXT")->getSize(), SHORT_DECLARED_SIZE);
+
+	auto mapped = loadMapped("SHORT.TXT");
+	auto file = loadFromFile("SHORT.TXT");
+
+	EXPECT_EQ(readAll(*mapped, SHORT_DECLARED_SIZE), shortData);
+	EXPECT_EQ(readAll(*file, SHORT_SIZE), shortData);
+	EXPECT_EQ(mapped->tell(), SHORT_SIZE);
+	EXPECT_EQ(mapped->getSize(), SHORT_SIZE);
+	EXPECT_EQ(mapped->getSize(), file->getSize());
+
+	auto buffered = loadMapped("SHORT.TXT");
+	EXPECT_EQ(readAll(*buffered, 10), std::vector<ui8>(shortData.begin(), shortData.begin() + 10));
+	EXPECT_EQ(buffered->getSize(), SHORT_SIZE);
+
+	checkPartialAccess("SHORT.TXT");
+}
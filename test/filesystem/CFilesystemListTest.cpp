@@ -0,0 +1,164 @@
+/*
+ * CFilesystemListTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/filesystem/AdapterLoaders.h"
+#include "../lib/filesystem/CMemoryStream.h"
+#include "../lib/filesystem/ResourcePath.h"
+
+namespace
+{
+
+class FakeLoader : public ISimpleResourceLoader
+{
+public:
+	std::unordered_set<ResourcePath> files;
+	mutable int loadCalls = 0;
+	mutable int listCalls = 0;
+
+	FakeLoader(std::initializer_list<std::string> names)
+	{
+		for(const auto & name : names)
+			files.insert(ResourcePath(name));
+	}
+
+	std::unique_ptr<CInputStream> load(const ResourcePath & resourceName) const override
+	{
+		loadCalls++;
+		return std::make_unique<CMemoryStream>(nullptr, 0);
+	}
+
+	bool existsResource(const ResourcePath & resourceName) const override
+	{
+		return files.count(resourceName) != 0;
+	}
+
+	std::string getMountPoint() const override
+	{
+		return "";
+	}
+
+	void updateFilteredFiles(std::function<bool(const std::string &)> filter) const override {}
+
+	std::unordered_set<ResourcePath> getFilteredFiles(std::function<bool(const ResourcePath &)> filter) const override
+	{
+		listCalls++;
+		std::unordered_set<ResourcePath> result;
+		for(const auto & file : files)
+			if(filter(file))
+				result.insert(file);
+		return result;
+	}
+
+	bool createResource(const std::string & filename, bool update) override
+	{
+		files.insert(ResourcePath(filename));
+		return true;
+	}
+};
+
+}
+
+TEST(CFilesystemListTest, lastMountedLoaderOverridesResource)
+{
+	CFilesystemList subject;
+	auto * first = new FakeLoader({"DATA/A.TXT", "DATA/B.TXT"});
+	auto * second = new FakeLoader({"DATA/A.TXT"});
+	subject.addLoader(first, false);
+	subject.addLoader(second, false);
+
+	subject.load(ResourcePath("DATA/A.TXT"));
+	subject.load(ResourcePath("DATA/B.TXT"));
+
+	EXPECT_EQ(first->loadCalls, 1);
+	EXPECT_EQ(second->loadCalls, 1);
+	EXPECT_THROW(subject.load(ResourcePath("DATA/C.TXT")), std::runtime_error);
+
+	std::vector<const ISimpleResourceLoader *> expected = {first, second};
+	EXPECT_EQ(subject.getResourcesWithName(ResourcePath("DATA/A.TXT")), expected);
+}
+
+TEST(CFilesystemListTest, nestedListsReturnLeafLoaders)
+{
+	CFilesystemList subject;
+	auto * nested = new CFilesystemList();
+	auto * first = new FakeLoader({"DATA/A.TXT"});
+	auto * second = new FakeLoader({"DATA/A.TXT"});
+	auto * third = new FakeLoader({"DATA/A.TXT"});
+	subject.addLoader(first, false);
+	subject.addLoader(nested, false);
+	nested->addLoader(second, false);
+	nested->addLoader(third, false);
+
+	std::vector<const ISimpleResourceLoader *> expected = {first, second, third};
+	EXPECT_EQ(subject.getResourcesWithName(ResourcePath("DATA/A.TXT")), expected);
+}
+
+TEST(CFilesystemListTest, indexIsUpdatedOnFilesystemChanges)
+{
+	CFilesystemList subject;
+	auto * nested = new CFilesystemList();
+	auto * writeable = new FakeLoader({});
+	subject.addLoader(nested, false);
+	nested->addLoader(writeable, true);
+
+	EXPECT_FALSE(subject.existsResource(ResourcePath("DATA/A.TXT")));
+
+	auto * mod = new FakeLoader({"DATA/A.TXT"});
+	subject.addLoader(mod, false);
+	EXPECT_TRUE(subject.existsResource(ResourcePath("DATA/A.TXT")));
+
+	subject.removeLoader(mod);
+	EXPECT_FALSE(subject.existsResource(ResourcePath("DATA/A.TXT")));
+
+	nested->createResource("DATA/A.TXT");
+	EXPECT_TRUE(subject.existsResource(ResourcePath("DATA/A.TXT")));
+}
+
+TEST(CFilesystemListTest, overwritingExistingResourceKeepsIndex)
+{
+	CFilesystemList subject;
+	auto * writeable = new FakeLoader({"SAVES/A.VSGM1"});
+	subject.addLoader(writeable, true);
+
+	EXPECT_TRUE(subject.existsResource(ResourcePath("SAVES/A.VSGM1")));
+	EXPECT_EQ(writeable->listCalls, 1);
+
+	EXPECT_TRUE(subject.createResource("SAVES/A.VSGM1"));
+	EXPECT_TRUE(subject.existsResource(ResourcePath("SAVES/A.VSGM1")));
+	EXPECT_EQ(writeable->listCalls, 1);
+
+	EXPECT_TRUE(subject.createResource("SAVES/B.VSGM1"));
+	EXPECT_TRUE(subject.existsResource(ResourcePath("SAVES/B.VSGM1")));
+	EXPECT_EQ(writeable->listCalls, 2);
+}
+
+TEST(CFilesystemListTest, changeInNestedListKeepsIndexOfSiblings)
+{
+	CFilesystemList subject;
+	auto * local = new CFilesystemList();
+	auto * data = new CFilesystemList();
+	auto * writeable = new FakeLoader({});
+	auto * content = new FakeLoader({"DATA/A.TXT"});
+	subject.addLoader(data, false);
+	subject.addLoader(local, true);
+	data->addLoader(content, false);
+	local->addLoader(writeable, true);
+
+	EXPECT_TRUE(data->existsResource(ResourcePath("DATA/A.TXT")));
+	EXPECT_FALSE(subject.existsResource(ResourcePath("DATA/B.TXT")));
+	int dataListCalls = content->listCalls;
+
+	local->createResource("DATA/B.TXT");
+
+	EXPECT_TRUE(data->existsResource(ResourcePath("DATA/A.TXT")));
+	EXPECT_EQ(content->listCalls, dataListCalls);
+	EXPECT_TRUE(subject.existsResource(ResourcePath("DATA/B.TXT")));
+}
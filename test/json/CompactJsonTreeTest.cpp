@@ -0,0 +1,108 @@
+/*
+ * CompactJsonTreeTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../../lib/json/CompactJsonTree.h"
+#include "../../lib/serializer/CMemorySerializer.h"
+
+static JsonNode makeTestNode()
+{
+	const std::string text = R"({
+		"name" : "Pikeman",
+		"level" : 1,
+		"speed" : 4.5,
+		"shooter" : false,
+		"upgrades" : [ "halberdier", null, { "cost" : 100 } ],
+		"abilities" : { "defence" : { "val" : 2 }, "attack" : { "val" : 1 } },
+		"empty" : {}
+	})";
+
+	JsonNode node(reinterpret_cast<const std::byte *>(text.data()), text.size(), "test");
+	node.setModScope("core");
+	node["abilities"]["attack"].setModScope("otherMod");
+	node["abilities"]["defence"].setOverrideFlag(true);
+	return node;
+}
+
+TEST(CompactJsonTreeTest, convertsBackToSameJson)
+{
+	const JsonNode source = makeTestNode();
+	const JsonNode converted = CompactJsonTree(source).root().toJsonNode();
+
+	EXPECT_EQ(converted, source);
+	EXPECT_EQ(converted.getModScope(), "core");
+	EXPECT_EQ(converted["upgrades"][0].getModScope(), "core");
+	EXPECT_EQ(converted["abilities"]["attack"].getModScope(), "otherMod");
+	EXPECT_TRUE(converted["abilities"]["defence"].getOverrideFlag());
+	EXPECT_FALSE(converted["abilities"]["attack"].getOverrideFlag());
+}
+
+TEST(CompactJsonTreeTest, readsValuesWithoutConversion)
+{
+	const CompactJsonTree tree(makeTestNode());
+	const CompactJsonView root = tree.root();
+
+	ASSERT_TRUE(root.isStruct());
+	EXPECT_EQ(root.size(), 7);
+	EXPECT_EQ(root["name"].String(), "Pikeman");
+	EXPECT_EQ(root["level"].Integer(), 1);
+	EXPECT_DOUBLE_EQ(root["level"].Float(), 1.0);
+	EXPECT_DOUBLE_EQ(root["speed"].Float(), 4.5);
+	EXPECT_FALSE(root["shooter"].Bool());
+
+	ASSERT_TRUE(root["upgrades"].isVector());
+	EXPECT_EQ(root["upgrades"].size(), 3);
+	EXPECT_EQ(root["upgrades"][0].String(), "halberdier");
+	EXPECT_TRUE(root["upgrades"][1].isNull());
+	EXPECT_EQ(root["upgrades"][2]["cost"].Integer(), 100);
+
+	EXPECT_TRUE(root["empty"].isStruct());
+	EXPECT_EQ(root["empty"].size(), 0);
+
+	EXPECT_TRUE(root["missing"].isNull());
+	EXPECT_TRUE(root["name"]["missing"].isNull());
+	EXPECT_TRUE(root["missing"]["missing"].isNull());
+}
+
+TEST(CompactJsonTreeTest, structEntriesAreSortedByName)
+{
+	const CompactJsonTree tree(makeTestNode());
+	const CompactJsonView abilities = tree.root()["abilities"];
+
+	ASSERT_EQ(abilities.size(), 2);
+	EXPECT_EQ(abilities.keyAt(0), "attack");
+	EXPECT_EQ(abilities.keyAt(1), "defence");
+	EXPECT_EQ(abilities.valueAt(0)["val"].Integer(), 1);
+	EXPECT_EQ(abilities.valueAt(1)["val"].Integer(), 2);
+}
+
+TEST(CompactJsonTreeTest, emptyTreeIsNull)
+{
+	EXPECT_TRUE(CompactJsonTree().root().isNull());
+	EXPECT_TRUE(CompactJsonTree(JsonNode()).root().isNull());
+	EXPECT_TRUE(CompactJsonTree().root().toJsonNode().isNull());
+}
+
+TEST(CompactJsonTreeTest, serialization)
+{
+	const JsonNode source = makeTestNode();
+	CompactJsonTree saved(source);
+	CompactJsonTree loaded;
+
+	CMemorySerializer mem;
+	mem.oser & saved;
+	mem.iser & loaded;
+
+	const JsonNode converted = loaded.root().toJsonNode();
+	EXPECT_EQ(converted, source);
+	EXPECT_EQ(converted["abilities"]["attack"].getModScope(), "otherMod");
+	EXPECT_TRUE(converted["abilities"]["defence"].getOverrideFlag());
+}
@@ -0,0 +1,225 @@
+/*
+ * TerrainChunkCacheTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../lib/GameSettings.h"
+#include "../lib/bonuses/Limiters.h"
+#include "../lib/bonuses/Propagators.h"
+#include "../lib/bonuses/Updaters.h"
+#include "../lib/entities/hero/CHero.h"
+#include "../lib/mapObjects/CGHeroInstance.h"
+#include "../lib/mapObjects/CGTownInstance.h"
+#include "../lib/mapObjects/CQuest.h"
+#include "../lib/mapObjects/MiscObjects.h"
+#include "../lib/mapObjects/ObjectTemplate.h"
+#include "../lib/mapObjects/TownBuildingInstance.h"
+#include "../lib/mapping/CMap.h"
+#include "../lib/mapping/TerrainChunkCache.h"
+#include "../lib/serializer/CMemorySerializer.h"
+#include "../lib/RiverHandler.h"
+#include "../lib/RoadHandler.h"
+#include "../lib/TerrainHandler.h"
+#include "../lib/VCMI_Lib.h"
+
+namespace test
+{
+using namespace ::testing;
+
+class CMapTerrainSerializationTest : public Test
+{
+public:
+	std::unique_ptr<CMap> original;
+	std::unique_ptr<CMap> loaded;
+
+	void SetUp() override
+	{
+		original = makeMap(0);
+	}
+
+	static std::unique_ptr<CMap> makeMap(int seed)
+	{
+		static const TerrainId terrains[] = { ETerrainId::GRASS, ETerrainId::DIRT, ETerrainId::SAND, ETerrainId::SNOW, ETerrainId::WATER };
+
+		// size is not multiple of chunk size to cover partial chunks
+		auto map = std::make_unique<CMap>(nullptr);
+		map->width = 40;
+		map->height = 35;
+		map->twoLevel = true;
+		map->initTerrain();
+
+		for(int z = 0; z < map->levels(); ++z)
+		{
+			for(int x = 0; x < map->width; ++x)
+			{
+				for(int y = 0; y < map->height; ++y)
+				{
+					TerrainTile & tile = map->getTile(int3(x, y, z));
+					tile.terType = const_cast<TerrainType *>(VLC->terrainTypeHandler->getById(terrains[(x * 7 + y * 3 + z + seed) % std::size(terrains)]));
+					tile.terView = (x + y + seed) % 20;
+					tile.extTileFlags = (x + seed) % 4;
+					tile.visitable = (x + y) % 5 == 0;
+					tile.blocked = (x * y) % 7 == 0;
+				}
+			}
+		}
+		return map;
+	}
+
+	static std::unordered_set<int64_t> knownHashes(const TerrainChunkCache & cache)
+	{
+		auto hashes = cache.getHashes();
+		return std::unordered_set<int64_t>(hashes.begin(), hashes.end());
+	}
+
+	/// Sends map through serializer, chunks known to receiver are restored from provided cache
+	void transfer(const CMap & map, const std::unordered_set<int64_t> * known, const TerrainChunkCache * cache)
+	{
+		CMemorySerializer mem;
+		mem.oser.knownTerrainChunks = known;
+		mem.iser.terrainChunkCache = cache;
+
+		mem.oser & map;
+		loaded = std::make_unique<CMap>(nullptr);
+		mem.iser & *loaded;
+	}
+
+	void compareTerrain(const CMap & expectedMap) const
+	{
+		ASSERT_EQ(loaded->width, expectedMap.width);
+		ASSERT_EQ(loaded->height, expectedMap.height);
+		ASSERT_EQ(loaded->levels(), expectedMap.levels());
+
+		for(int z = 0; z < expectedMap.levels(); ++z)
+		{
+			for(int x = 0; x < expectedMap.width; ++x)
+			{
+				for(int y = 0; y < expectedMap.height; ++y)
+				{
+					const TerrainTile & expected = expectedMap.getTile(int3(x, y, z));
+					const TerrainTile & actual = loaded->getTile(int3(x, y, z));
+
+					EXPECT_EQ(actual.terType, expected.terType) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.riverType, expected.riverType) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.roadType, expected.roadType) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.terView, expected.terView) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.riverDir, expected.riverDir) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.roadDir, expected.roadDir) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.extTileFlags, expected.extTileFlags) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.visitable, expected.visitable) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.blocked, expected.blocked) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.visitableObjects, expected.visitableObjects) << int3(x, y, z).toString();
+					EXPECT_EQ(actual.blockingObjects, expected.blockingObjects) << int3(x, y, z).toString();
+				}
+			}
+		}
+	}
+};
+
+TEST_F(CMapTerrainSerializationTest, fullTerrain)
+{
+	transfer(*original, nullptr, nullptr);
+	compareTerrain(*original);
+}
+
+TEST_F(CMapTerrainSerializationTest, cachedChunksAreRestored)
+{
+	TerrainChunkCache cache;
+	original->storeTerrain(cache);
+	auto known = knownHashes(cache);
+
+	// chunk with changed static data must be sent in full, chunk with changed flags only keeps cached static data
+	original->getTile(int3(5, 5, 0)).terType = const_cast<TerrainType *>(VLC->terrainTypeHandler->getById(ETerrainId::LAVA));
+	original->getTile(int3(20, 20, 1)).visitable = !original->getTile(int3(20, 20, 1)).visitable;
+
+	transfer(*original, &known, &cache);
+	compareTerrain(*original);
+}
+
+TEST_F(CMapTerrainSerializationTest, missingCacheThrows)
+{
+	TerrainChunkCache cache;
+	original->storeTerrain(cache);
+	auto known = knownHashes(cache);
+
+	EXPECT_THROW(transfer(*original, &known, nullptr), std::runtime_error);
+}
+
+TEST_F(CMapTerrainSerializationTest, mismatchedCacheThrows)
+{
+	TerrainChunkCache cache;
+	original->storeTerrain(cache);
+	auto known = knownHashes(cache);
+
+	TerrainChunkCache otherCache;
+	makeMap(1)->storeTerrain(otherCache);
+
+	EXPECT_THROW(transfer(*original, &known, &otherCache), std::runtime_error);
+}
+
+TEST_F(CMapTerrainSerializationTest, acknowledgedGenerationPrunesOlderChunks)
+{
+	auto other = makeMap(1);
+
+	TerrainChunkCache cache;
+	original->storeTerrain(cache);
+	auto knownOriginal = knownHashes(cache);
+	const uint32_t firstGeneration = cache.getGeneration();
+
+	other->storeTerrain(cache);
+	auto knownOther = knownHashes(cache);
+	EXPECT_EQ(cache.getGeneration(), firstGeneration + 1);
+	EXPECT_EQ(knownOther.size(), 2 * 3 * 3);
+
+	// until other side acknowledged new generation it may still send chunks of previous one
+	transfer(*original, &knownOriginal, &cache);
+	compareTerrain(*original);
+
+	cache.prune(cache.getGeneration());
+	EXPECT_THROW(transfer(*original, &knownOriginal, &cache), std::runtime_error);
+
+	transfer(*other, &knownOther, &cache);
+	compareTerrain(*other);
+}
+
+TEST_F(CMapTerrainSerializationTest, onlyTwoLatestGenerationsAreKept)
+{
+	auto second = makeMap(1);
+	auto third = makeMap(2);
+
+	TerrainChunkCache cache;
+	original->storeTerrain(cache);
+	auto knownOriginal = knownHashes(cache);
+	second->storeTerrain(cache);
+	auto knownSecond = knownHashes(cache);
+	third->storeTerrain(cache);
+
+	EXPECT_THROW(transfer(*original, &knownOriginal, &cache), std::runtime_error);
+
+	transfer(*second, &knownSecond, &cache);
+	compareTerrain(*second);
+}
+
+TEST_F(CMapTerrainSerializationTest, unchangedChunksStayInLatestGeneration)
+{
+	TerrainChunkCache cache;
+	original->storeTerrain(cache);
+	auto known = knownHashes(cache);
+
+	// same map is played again, acknowledging its new generation must not discard any of its chunks
+	original->storeTerrain(cache);
+	EXPECT_EQ(knownHashes(cache), known);
+	cache.prune(cache.getGeneration());
+
+	transfer(*original, &known, &cache);
+	compareTerrain(*original);
+}
+
+}
@@ -0,0 +1,175 @@
+/*
+ * NodeQueueTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/pathfinder/CGPathNode.h"
+#include "../lib/pathfinder/NodeQueue.h"
+
+namespace
+{
+
+/// Synthetic two-level map, movement costs are multiples of 1/64 of a turn so costs of different searches can be compared exactly
+struct TestGraph
+{
+	int3 sizes;
+
+	size_t indexOf(const int3 & tile) const
+	{
+		return (tile.z * sizes.x + tile.x) * sizes.y + tile.y;
+	}
+
+	static float stepCost(const int3 & tile)
+	{
+		return static_cast<float>(1 + (tile.x * 7 + tile.y * 13 + tile.z * 5) % 11) / 64.0f;
+	}
+
+	std::vector<int3> neighbours(const int3 & tile) const
+	{
+		std::vector<int3> result;
+		for(int dx = -1; dx <= 1; dx++)
+		{
+			for(int dy = -1; dy <= 1; dy++)
+			{
+				int3 neighbour = tile + int3(dx, dy, 0);
+				if((dx || dy) && neighbour.x >= 0 && neighbour.y >= 0 && neighbour.x < sizes.x && neighbour.y < sizes.y)
+					result.push_back(neighbour);
+			}
+		}
+
+		// underground gates every 16 tiles
+		if(tile.x % 16 == 0 && tile.y % 16 == 0)
+			result.push_back(int3(tile.x, tile.y, 1 - tile.z));
+
+		return result;
+	}
+};
+
+/// Runs Dijkstra on path nodes ordered by NodeHeapQueue, the same way as CPathfinder does
+void runSearch(const TestGraph & graph, std::vector<CGPathNode> & nodes)
+{
+	NodeHeapQueue queue;
+
+	for(int z = 0; z < graph.sizes.z; z++)
+		for(int x = 0; x < graph.sizes.x; x++)
+			for(int y = 0; y < graph.sizes.y; y++)
+				nodes[graph.indexOf(int3(x, y, z))].update(int3(x, y, z), EPathfindingLayer::LAND, EPathAccessibility::ACCESSIBLE);
+
+	CGPathNode & initial = nodes[graph.indexOf(int3(0, 0, 0))];
+	initial.setCost(0);
+	queue.push(&initial);
+
+	float lastCost = 0;
+	while(!queue.empty())
+	{
+		CGPathNode * node = queue.topAndPop();
+		EXPECT_LE(lastCost, node->getCost());
+		lastCost = node->getCost();
+		node->locked = true;
+
+		for(const auto & tile : graph.neighbours(node->coord))
+		{
+			CGPathNode & neighbour = nodes[graph.indexOf(tile)];
+			float cost = node->getCost() + TestGraph::stepCost(tile);
+
+			if(neighbour.locked || cost >= neighbour.getCost())
+				continue;
+
+			// cost of node that is already queued is changed in place
+			neighbour.setCost(cost);
+			neighbour.theNodeBefore = node;
+
+			if(!neighbour.inPQ())
+				queue.push(&neighbour);
+		}
+	}
+}
+
+/// Reference Dijkstra with std::priority_queue, outdated queue entries are skipped instead of updated
+std::vector<float> runReferenceSearch(const TestGraph & graph)
+{
+	using TEntry = std::pair<float, size_t>;
+
+	std::vector<float> costs(graph.sizes.x * graph.sizes.y * graph.sizes.z, std::numeric_limits<float>::max());
+	std::vector<int3> tiles(costs.size());
+	std::priority_queue<TEntry, std::vector<TEntry>, std::greater<TEntry>> queue;
+
+	for(int z = 0; z < graph.sizes.z; z++)
+		for(int x = 0; x < graph.sizes.x; x++)
+			for(int y = 0; y < graph.sizes.y; y++)
+				tiles[graph.indexOf(int3(x, y, z))] = int3(x, y, z);
+
+	costs[graph.indexOf(int3(0, 0, 0))] = 0;
+	queue.emplace(0, graph.indexOf(int3(0, 0, 0)));
+
+	while(!queue.empty())
+	{
+		auto [cost, index] = queue.top();
+		queue.pop();
+
+		if(cost > costs[index])
+			continue;
+
+		for(const auto & tile : graph.neighbours(tiles[index]))
+		{
+			float newCost = cost + TestGraph::stepCost(tile);
+			size_t neighbour = graph.indexOf(tile);
+
+			if(newCost < costs[neighbour])
+			{
+				costs[neighbour] = newCost;
+				queue.emplace(newCost, neighbour);
+			}
+		}
+	}
+
+	return costs;
+}
+
+}
+
+TEST(NodeQueueTest, sameCostsAsReferenceSearch)
+{
+	const TestGraph graph{int3(72, 72, 2)};
+	std::vector<CGPathNode> nodes(graph.sizes.x * graph.sizes.y * graph.sizes.z);
+
+	runSearch(graph, nodes);
+	auto expected = runReferenceSearch(graph);
+
+	for(size_t i = 0; i < nodes.size(); i++)
+	{
+		ASSERT_TRUE(nodes[i].locked);
+		ASSERT_EQ(nodes[i].getCost(), expected[i]) << nodes[i].coord.toString();
+		ASSERT_FALSE(nodes[i].inPQ());
+	}
+}
+
+TEST(NodeQueueTest, costUpdatesKeepOrder)
+{
+	std::vector<CGPathNode> nodes(50);
+	NodeHeapQueue queue;
+
+	for(size_t i = 0; i < nodes.size(); i++)
+	{
+		nodes[i].setCost(static_cast<float>(100 - i));
+		queue.push(&nodes[i]);
+	}
+
+	for(size_t i = 0; i < nodes.size(); i += 3)
+		nodes[i].setCost(static_cast<float>(i));
+
+	float lastCost = 0;
+	while(!queue.empty())
+	{
+		auto * node = queue.topAndPop();
+		EXPECT_FALSE(node->inPQ());
+		EXPECT_LE(lastCost, node->getCost());
+		lastCost = node->getCost();
+	}
+}
@@ -0,0 +1,292 @@
+/*
+ * NodeStorageTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+#include "StdInc.h"
+
+#include "mock/mock_Services.h"
+#include "mock/mock_MapService.h"
+#include "mock/mock_IGameCallback.h"
+
+#include "../../lib/gameState/CGameState.h"
+#include "../../lib/mapObjectConstructors/AObjectTypeHandler.h"
+#include "../../lib/mapObjectConstructors/CObjectClassesHandler.h"
+#include "../../lib/mapObjects/CGCreature.h"
+#include "../../lib/mapObjects/CGHeroInstance.h"
+#include "../../lib/mapping/CMap.h"
+#include "../../lib/networkPacks/PacksForClient.h"
+#include "../../lib/pathfinder/CGPathNode.h"
+#include "../../lib/filesystem/ResourcePath.h"
+#include "../../lib/StartInfo.h"
+#include "../../lib/TerrainHandler.h"
+#include "../../lib/VCMI_Lib.h"
+
+/// Paths repaired after small change must be the same as paths calculated from scratch
+class NodeStorageTest : public ::testing::Test, public ServerCallback, public MapListener
+{
+public:
+	NodeStorageTest()
+		: gameCallback(new GameCallbackMock(this)),
+		mapService("test/MiniTest/", this),
+		map(nullptr)
+	{
+	}
+
+	void SetUp() override
+	{
+		gameState = std::make_shared<CGameState>();
+		gameCallback->setGameState(gameState.get());
+		gameState->preInit(&services, gameCallback.get());
+		startTestGame();
+
+		hero = gameState->getHero(map->heroesOnMap.front()->id);
+		ASSERT_NE(hero, nullptr);
+	}
+
+	void TearDown() override
+	{
+		gameState.reset();
+	}
+
+	bool describeChanges() const override
+	{
+		return true;
+	}
+
+	void apply(CPackForClient & pack) override
+	{
+		gameState->apply(pack);
+	}
+
+	void apply(BattleLogMessage & pack) override {}
+	void apply(BattleStackMoved & pack) override {}
+	void apply(BattleUnitsChanged & pack) override {}
+	void apply(SetStackEffect & pack) override {}
+	void apply(StacksInjured & pack) override {}
+	void apply(BattleObstaclesChanged & pack) override {}
+	void apply(CatapultAttack & pack) override {}
+
+	void complain(const std::string & problem) override
+	{
+		FAIL() << "Server-side assertion: " << problem;
+	}
+
+	vstd::RNG * getRNG() override
+	{
+		return &gameState->getRandomGenerator();
+	}
+
+	void mapLoaded(CMap * map) override
+	{
+		EXPECT_EQ(this->map, nullptr);
+		this->map = map;
+	}
+
+	void startTestGame()
+	{
+		StartInfo si;
+		si.mapname = "anything";//does not matter, map service mocked
+		si.difficulty = 0;
+		si.mode = EStartMode::NEW_GAME;
+
+		std::unique_ptr<CMapHeader> header = mapService.loadMapHeader(ResourcePath(si.mapname));
+
+		ASSERT_NE(header.get(), nullptr);
+
+		for(int i = 0; i < header->players.size(); i++)
+		{
+			const PlayerInfo & pinfo = header->players[i];
+
+			if (!(pinfo.canHumanPlay || pinfo.canComputerPlay))
+				continue;
+
+			PlayerSettings & pset = si.playerInfos[PlayerColor(i)];
+			pset.color = PlayerColor(i);
+			pset.connectedPlayerIDs.insert(i);
+			pset.name = "Player";
+			pset.castle = pinfo.defaultCastle();
+			pset.hero = pinfo.defaultHero();
+
+			if(pset.hero != HeroTypeID::RANDOM && pinfo.hasCustomMainHero())
+			{
+				pset.hero = pinfo.mainCustomHeroId;
+				pset.heroNameTextId = pinfo.mainCustomHeroNameTextId;
+				pset.heroPortrait = HeroTypeID(pinfo.mainCustomHeroPortrait);
+			}
+		}
+
+		Load::ProgressAccumulator progressTracker;
+		gameState->init(&mapService, &si, progressTracker, false);
+
+		ASSERT_NE(map, nullptr);
+		ASSERT_EQ(map->heroesOnMap.size(), 2);
+	}
+
+	const CGObjectInstance * createMonster(const int3 & visitablePosition, CreatureID creature)
+	{
+		auto handler = VLC->objtypeh->getHandlerFor(Obj::MONSTER, creature);
+		TerrainId terrainType = map->getTile(visitablePosition).terType->getId();
+
+		CGObjectInstance * object = handler->create(gameCallback.get(), nullptr);
+		handler->configureObject(object, gameState->getRandomGenerator());
+
+		if (!handler->getTemplates(terrainType).empty())
+			object->appearance = handler->getTemplates(terrainType).front();
+		else
+			object->appearance = handler->getTemplates().front();
+
+		object->setAnchorPos(visitablePosition + object->getVisitableOffset());
+
+		auto * monster = dynamic_cast<CGCreature *>(object);
+		EXPECT_NE(monster, nullptr);
+		monster->addToSlot(SlotID(0), new CStackInstance(creature, 1));
+		object->initObj(gameState->getRandomGenerator());
+
+		NewObject no;
+		no.newObject = object;
+		no.initiator = PlayerColor::NEUTRAL;
+		gameCallback->sendAndApply(no);
+
+		return object;
+	}
+
+	void removeObject(const CGObjectInstance * object)
+	{
+		RemoveObject ro(object->id, PlayerColor::NEUTRAL);
+		gameCallback->sendAndApply(ro);
+	}
+
+	/// Moves hero to node of previously calculated paths that is reachable in current turn
+	void moveHeroAlongPath(const CPathsInfo & paths)
+	{
+		const CGPathNode * destination = nullptr;
+
+		for(const auto & dir : int3::getDirs())
+		{
+			const int3 tile = hero->visitablePos() + dir;
+			if(!map->isInTheMap(tile))
+				continue;
+
+			const CGPathNode * node = paths.getPathInfo(tile);
+			if(node->reachable() && node->turns == 0 && node->action == EPathNodeAction::NORMAL)
+			{
+				destination = node;
+				break;
+			}
+		}
+
+		ASSERT_NE(destination, nullptr);
+
+		TryMoveHero tmh;
+		tmh.id = hero->id;
+		tmh.start = hero->pos;
+		tmh.end = hero->convertFromVisitablePos(destination->coord);
+		tmh.movePoints = destination->moveRemains;
+		tmh.result = TryMoveHero::SUCCESS;
+		gameCallback->sendAndApply(tmh);
+
+		ASSERT_EQ(hero->visitablePos(), destination->coord);
+	}
+
+	static void expectSameNode(const CGPathNode * repaired, const CGPathNode * fresh)
+	{
+		const std::string where = fresh->coord.toString() + " layer " + std::to_string(fresh->layer.getNum());
+
+		EXPECT_EQ(repaired->reachable(), fresh->reachable()) << where;
+		if(!fresh->reachable())
+			return;
+
+		EXPECT_NEAR(repaired->getCost(), fresh->getCost(), 0.0001f) << where;
+		EXPECT_EQ(repaired->turns, fresh->turns) << where;
+		EXPECT_EQ(repaired->moveRemains, fresh->moveRemains) << where;
+		EXPECT_EQ(repaired->action, fresh->action) << where;
+
+		ASSERT_EQ(repaired->theNodeBefore == nullptr, fresh->theNodeBefore == nullptr) << where;
+		if(!fresh->theNodeBefore)
+			return;
+
+		// there may be several equally good paths, search is free to keep any of them
+		const CGPathNode * repairedBefore = repaired->theNodeBefore;
+		const CGPathNode * freshBefore = fresh->theNodeBefore;
+
+		if(repairedBefore->coord != freshBefore->coord || repairedBefore->layer != freshBefore->layer)
+		{
+			EXPECT_NEAR(repairedBefore->getCost(), freshBefore->getCost(), 0.0001f) << where;
+			EXPECT_EQ(repairedBefore->turns, freshBefore->turns) << where;
+			EXPECT_EQ(repairedBefore->moveRemains, freshBefore->moveRemains) << where;
+		}
+	}
+
+	/// Calculates paths again using previous results and compares them with paths calculated from scratch
+	void checkRepairedPaths(CPathsInfo & paths)
+	{
+		gameState->calculatePaths(hero, paths);
+
+		CPathsInfo fresh(gameState->getMapSize(), hero);
+		gameState->calculatePaths(hero, fresh);
+
+		const int3 sizes = gameState->getMapSize();
+		int3 pos;
+
+		for(pos.z = 0; pos.z < sizes.z; ++pos.z)
+		{
+			for(pos.x = 0; pos.x < sizes.x; ++pos.x)
+			{
+				for(pos.y = 0; pos.y < sizes.y; ++pos.y)
+				{
+					for(EPathfindingLayer layer = EPathfindingLayer::LAND; layer < EPathfindingLayer::NUM_LAYERS; layer.advance(1))
+					{
+						ASSERT_EQ(paths.hasLayer(layer), fresh.hasLayer(layer));
+
+						if(fresh.hasLayer(layer))
+							expectSameNode(paths.getNode(pos, layer), fresh.getNode(pos, layer));
+					}
+				}
+			}
+		}
+	}
+
+	std::shared_ptr<CGameState> gameState;
+	std::shared_ptr<GameCallbackMock> gameCallback;
+	MapServiceMock mapService;
+	ServicesMock services;
+	CMap * map;
+	CGHeroInstance * hero = nullptr;
+};
+
+TEST_F(NodeStorageTest, heroStepAlongPath)
+{
+	CPathsInfo paths(gameState->getMapSize(), hero);
+	gameState->calculatePaths(hero, paths);
+
+	moveHeroAlongPath(paths);
+	checkRepairedPaths(paths);
+}
+
+TEST_F(NodeStorageTest, objectRemoved)
+{
+	const CGHeroInstance * otherHero = map->heroesOnMap.back();
+
+	CPathsInfo paths(gameState->getMapSize(), hero);
+	gameState->calculatePaths(hero, paths);
+
+	removeObject(otherHero);
+	checkRepairedPaths(paths);
+}
+
+TEST_F(NodeStorageTest, guardKilled)
+{
+	const CGObjectInstance * monster = createMonster(int3(4, 5, 0), CreatureID::AIR_ELEMENTAL);
+
+	CPathsInfo paths(gameState->getMapSize(), hero);
+	gameState->calculatePaths(hero, paths);
+	EXPECT_EQ(gameState->guardingCreaturePosition(int3(4, 4, 0)), monster->visitablePos());
+
+	removeObject(monster);
+	checkRepairedPaths(paths);
+}
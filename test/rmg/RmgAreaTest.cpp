@@ -0,0 +1,148 @@
+/*
+ * RmgAreaTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/rmg/RmgArea.h"
+
+namespace
+{
+
+// tiles spread over several words, including negative coordinates
+rmg::Tileset randomTiles(std::mt19937 & rng, int count)
+{
+	std::uniform_int_distribution<int> x(-70, 140);
+	std::uniform_int_distribution<int> y(-5, 20);
+	std::uniform_int_distribution<int> z(0, 1);
+
+	rmg::Tileset tiles;
+	for(int i = 0; i < count; ++i)
+		tiles.insert(int3(x(rng), y(rng), z(rng)));
+	return tiles;
+}
+
+rmg::Tileset referenceBorder(const rmg::Tileset & tiles)
+{
+	rmg::Tileset result;
+	for(const auto & tile : tiles)
+	{
+		for(const auto & dir : int3::getDirs())
+		{
+			if(!tiles.count(tile + dir))
+			{
+				result.insert(tile);
+				break;
+			}
+		}
+	}
+	return result;
+}
+
+rmg::Tileset referenceBorderOutside(const rmg::Tileset & tiles)
+{
+	rmg::Tileset result;
+	for(const auto & tile : tiles)
+	{
+		for(const auto & dir : int3::getDirs())
+		{
+			if(!tiles.count(tile + dir))
+				result.insert(tile + dir);
+		}
+	}
+	return result;
+}
+
+}
+
+TEST(RmgAreaTest, setOperationsMatchTileset)
+{
+	std::mt19937 rng(42);
+
+	for(int i = 0; i < 50; ++i)
+	{
+		const auto a = randomTiles(rng, 300);
+		const auto b = randomTiles(rng, 300);
+
+		rmg::Tileset united = a;
+		united.insert(b.begin(), b.end());
+		rmg::Tileset intersection;
+		rmg::Tileset difference;
+		for(const auto & tile : a)
+			(b.count(tile) ? intersection : difference).insert(tile);
+
+		rmg::Area areaA(a);
+		rmg::Area areaB(b);
+
+		EXPECT_EQ((areaA + areaB).getTiles(), united);
+		EXPECT_EQ((areaA * areaB).getTiles(), intersection);
+		EXPECT_EQ((areaA - areaB).getTiles(), difference);
+		EXPECT_EQ(areaA.overlap(areaB), !intersection.empty());
+		EXPECT_TRUE((areaA + areaB).contains(areaB));
+		EXPECT_EQ(areaA.contains(areaB), intersection.size() == b.size());
+	}
+}
+
+TEST(RmgAreaTest, bordersMatchNeighbourhood)
+{
+	std::mt19937 rng(7);
+
+	for(int i = 0; i < 50; ++i)
+	{
+		const auto tiles = randomTiles(rng, 1500);
+		rmg::Area area(tiles);
+
+		EXPECT_EQ(area.getBorder(), referenceBorder(tiles));
+		EXPECT_EQ(area.getBorderOutside(), referenceBorderOutside(tiles));
+	}
+}
+
+TEST(RmgAreaTest, translateAndAddKeepTiles)
+{
+	std::mt19937 rng(3);
+	const auto tiles = randomTiles(rng, 500);
+
+	for(const auto & shift : {int3(1, 0, 0), int3(-63, 2, 0), int3(64, -3, 1), int3(-130, 7, 0)})
+	{
+		rmg::Tileset shifted;
+		for(const auto & tile : tiles)
+			shifted.insert(tile + shift);
+
+		rmg::Area area(tiles);
+		area.translate(shift);
+		EXPECT_EQ(area.getTiles(), shifted);
+
+		rmg::Area added;
+		for(const auto & tile : shifted)
+			added.add(tile);
+		EXPECT_TRUE(added == area);
+	}
+}
+
+TEST(RmgAreaTest, connectedAreasSplitComponents)
+{
+	rmg::Area area;
+	// two blocks touching only diagonally, and one separate tile far away in other word
+	for(int x = 60; x < 64; ++x)
+		for(int y = 0; y < 3; ++y)
+			area.add(int3(x, y, 0));
+	for(int x = 64; x < 70; ++x)
+		for(int y = 3; y < 5; ++y)
+			area.add(int3(x, y, 0));
+	area.add(int3(200, 0, 0));
+
+	EXPECT_FALSE(area.connected());
+	EXPECT_EQ(connectedAreas(area, false).size(), 2);
+	EXPECT_EQ(connectedAreas(area, true).size(), 3);
+
+	std::map<int, rmg::Tileset> reverseDistanceMap;
+	auto distances = area.computeDistanceMap(reverseDistanceMap);
+	EXPECT_EQ(distances.size(), area.getTilesVector().size());
+	EXPECT_EQ(distances[int3(61, 1, 0)], 1);
+	EXPECT_EQ(distances[int3(200, 0, 0)], 0);
+}
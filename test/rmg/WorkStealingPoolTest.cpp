@@ -0,0 +1,58 @@
+/*
+ * WorkStealingPoolTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+#include "../lib/rmg/threadpool/WorkStealingPool.h"
+
+TEST(WorkStealingPoolTest, waitsForTasksSubmittedByTasks)
+{
+	WorkStealingPool pool(4);
+	std::atomic<int> counter = 0;
+
+	// every task spawns two children until depth is reached, like finished modificator releasing its successors
+	std::function<void(int)> task = [&](int depth)
+	{
+		++counter;
+		if(depth == 0)
+			return;
+
+		pool.submit([&task, depth](){ task(depth - 1); });
+		pool.submit([&task, depth](){ task(depth - 1); });
+	};
+
+	pool.submit([&task](){ task(9); });
+	pool.wait();
+
+	EXPECT_EQ(counter, (1 << 10) - 1);
+}
+
+TEST(WorkStealingPoolTest, rethrowsExceptionFromTask)
+{
+	WorkStealingPool pool(2);
+	std::atomic<int> counter = 0;
+
+	for(int i = 0; i < 10; i++)
+	{
+		pool.submit([&counter, i]()
+		{
+			++counter;
+			if(i == 5)
+				throw std::runtime_error("task failed");
+		});
+	}
+
+	EXPECT_THROW(pool.wait(), std::runtime_error);
+	EXPECT_EQ(counter, 10);
+
+	// pool is still usable after failure
+	pool.submit([&counter](){ ++counter; });
+	EXPECT_NO_THROW(pool.wait());
+	EXPECT_EQ(counter, 11);
+}
@@ -0,0 +1,100 @@
+/*
+ * BinarySerializerTest.cpp, part of VCMI engine
+ *
+ * Authors: listed in file AUTHORS in main folder
+ *
+ * License: GNU General Public License v2.0 or later
+ * Full text of license available in license.txt file, in main folder
+ *
+ */
+
+#include "StdInc.h"
+
+#include "../../lib/serializer/CMemorySerializer.h"
+
+TEST(BinarySerializerTest, independentStringsDoNotChangeStringTables)
+{
+	CMemorySerializer mem;
+
+	mem.oser & std::string("first");
+
+	// written in full and not added to string tables, even if serializer already knows them
+	mem.oser.independentStrings = true;
+	mem.oser & std::string("first");
+	mem.oser & std::string("second");
+	mem.oser & std::string("second");
+	mem.oser.independentStrings = false;
+
+	mem.oser & std::string("second");
+	mem.oser & std::string("first");
+	mem.oser & std::string("third");
+
+	std::vector<std::string> loaded(7);
+	for(auto & string : loaded)
+		mem.iser & string;
+
+	EXPECT_EQ(loaded, std::vector<std::string>({"first", "first", "second", "second", "second", "first", "third"}));
+	EXPECT_EQ(mem.oser.savedStrings.size(), 3);
+	EXPECT_EQ(mem.iser.loadedStrings.size(), 3);
+}
+
+TEST(BinarySerializerTest, repeatedBroadcastDoesNotGrowStringTables)
+{
+	CMemorySerializer mem;
+	const std::vector<std::string> pack = {"hero", "town", "hero", "artifact"};
+
+	mem.oser & std::string("town");
+	std::string loadedTown;
+	mem.iser & loadedTown;
+
+	const size_t savedBefore = mem.oser.savedStrings.size();
+	const size_t loadedBefore = mem.iser.loadedStrings.size();
+
+	for(int i = 0; i < 100; ++i)
+	{
+		mem.oser.independentStrings = true;
+		mem.oser & pack;
+		mem.oser.independentStrings = false;
+
+		std::vector<std::string> loaded;
+		mem.iser & loaded;
+
+		EXPECT_EQ(loaded, pack);
+		EXPECT_EQ(mem.oser.savedStrings.size(), savedBefore);
+		EXPECT_EQ(mem.iser.loadedStrings.size(), loadedBefore);
+	}
+
+	// string references that were sent before broadcasts remain valid
+	mem.oser & std::string("town");
+	mem.oser & std::string("hero");
+	std::string town;
+	std::string hero;
+	mem.iser & town;
+	mem.iser & hero;
+	EXPECT_EQ(town, "town");
+	EXPECT_EQ(hero, "hero");
+}
+
+TEST(BinarySerializerTest, largeIntegers)
+{
+	CMemorySerializer mem;
+	const std::vector<int64_t> values = {
+		0,
+		-1,
+		std::numeric_limits<int32_t>::max() + int64_t(1),
+		std::numeric_limits<int32_t>::min() - int64_t(1),
+		int64_t(1) << 50,
+		std::numeric_limits<int64_t>::max(),
+		std::numeric_limits<int64_t>::min()
+	};
+
+	for(auto value : values)
+		mem.oser & value;
+
+	for(auto value : values)
+	{
+		int64_t loaded = 0;
+		mem.iser & loaded;
+		EXPECT_EQ(loaded, value);
+	}
+}